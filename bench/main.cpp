@@ -0,0 +1,215 @@
+#include "algo/interval_tree.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Benchmark driver for IntervalTree: insert-heavy, query-heavy and mixed
+// workloads over uniform, clustered and nested interval distributions.
+// Reports ns/op plus hardware cache-miss and branch-miss counters per op
+// where perf_event is available (Linux, perf_event_paranoid permitting).
+//
+// Usage: bench [num_intervals] [num_queries]
+
+namespace {
+
+using Tree = algo::IntervalTree<int, int>;
+using IntervalVec = std::vector<algo::Interval<int>>;
+
+constexpr int kRange = 10'000'000;
+
+#ifdef __linux__
+class PerfCounter {
+public:
+    explicit PerfCounter(std::uint64_t config) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    ~PerfCounter() {
+        if (fd_ >= 0) {
+            close(fd_);
+        }
+    }
+
+    void start() {
+        if (fd_ >= 0) {
+            ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    long long stop() {
+        if (fd_ < 0) {
+            return -1;
+        }
+        ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        long long value = -1;
+        if (read(fd_, &value, sizeof(value)) != sizeof(value)) {
+            return -1;
+        }
+        return value;
+    }
+
+private:
+    int fd_ = -1;
+};
+#else
+class PerfCounter {
+public:
+    explicit PerfCounter(std::uint64_t) {}
+    void start() {}
+    long long stop() { return -1; }
+};
+#endif
+
+struct Measurement {
+    double ns_per_op = 0.0;
+    long long cache_misses = -1;
+    long long branch_misses = -1;
+};
+
+template <typename Body>
+Measurement measure(std::size_t ops, Body&& body) {
+#ifdef __linux__
+    PerfCounter cache(PERF_COUNT_HW_CACHE_MISSES);
+    PerfCounter branch(PERF_COUNT_HW_BRANCH_MISSES);
+#else
+    PerfCounter cache(0);
+    PerfCounter branch(0);
+#endif
+    cache.start();
+    branch.start();
+    auto begin = std::chrono::steady_clock::now();
+    body();
+    auto end = std::chrono::steady_clock::now();
+    Measurement m;
+    m.cache_misses = cache.stop();
+    m.branch_misses = branch.stop();
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+    m.ns_per_op = ops ? static_cast<double>(ns) / static_cast<double>(ops) : 0.0;
+    return m;
+}
+
+void report(const std::string& distribution, const std::string& op, std::size_t ops,
+            const Measurement& m) {
+    std::cout << distribution << "\t" << op << "\t" << ops << " ops\t" << m.ns_per_op << " ns/op";
+    if (m.cache_misses >= 0) {
+        std::cout << "\tcache-miss/op " << static_cast<double>(m.cache_misses) / ops;
+    }
+    if (m.branch_misses >= 0) {
+        std::cout << "\tbranch-miss/op " << static_cast<double>(m.branch_misses) / ops;
+    }
+    std::cout << std::endl;
+}
+
+IntervalVec generate(const std::string& distribution, std::size_t n, std::mt19937& g) {
+    IntervalVec intervals;
+    intervals.reserve(n);
+    if (distribution == "uniform") {
+        for (std::size_t i = 0; i < n; i++) {
+            int low = static_cast<int>(g() % kRange);
+            intervals.push_back({low, low + static_cast<int>(g() % 1000)});
+        }
+    } else if (distribution == "clustered") {
+        // A handful of hot centers, as in flow tables keyed by prefix.
+        std::vector<int> centers;
+        for (int c = 0; c < 64; c++) {
+            centers.push_back(static_cast<int>(g() % kRange));
+        }
+        for (std::size_t i = 0; i < n; i++) {
+            int low = centers[g() % centers.size()] + static_cast<int>(g() % 5000);
+            intervals.push_back({low, low + static_cast<int>(g() % 1000)});
+        }
+    } else {  // nested
+        for (std::size_t i = 0; i < n; i++) {
+            int center = kRange / 2 + static_cast<int>(g() % 1000);
+            int half = 1 + static_cast<int>(g() % (kRange / 2));
+            intervals.push_back({center - half, center + half});
+        }
+    }
+    return intervals;
+}
+
+void run(const std::string& distribution, std::size_t n, std::size_t num_queries) {
+    std::mt19937 g(42);
+    auto intervals = generate(distribution, n, g);
+    IntervalVec queries = generate("uniform", num_queries, g);
+
+    Tree tree;
+    report(distribution, "insert", n, measure(n, [&] {
+               for (std::size_t i = 0; i < intervals.size(); i++) {
+                   tree.insert(algo::Interval<int>{intervals[i]}, static_cast<int>(i));
+               }
+           }));
+
+    Tree::QueryContext ctx;
+    std::size_t matches = 0;
+    report(distribution, "walk", num_queries, measure(num_queries, [&] {
+               for (const auto& q : queries) {
+                   tree.query(q, ctx, [&](const auto& interval, const auto& value) { matches++; });
+               }
+           }));
+
+    std::size_t hits = 0;
+    report(distribution, "search", num_queries, measure(num_queries, [&] {
+               for (const auto& q : queries) {
+                   hits += tree.search(q) != nullptr;
+               }
+           }));
+
+    // Mixed: one insert + one remove + two queries per iteration.
+    std::size_t mixed_ops = num_queries;
+    report(distribution, "mixed", mixed_ops, measure(mixed_ops, [&] {
+               for (std::size_t i = 0; i < mixed_ops; i++) {
+                   const auto& q = queries[i % queries.size()];
+                   tree.insert(algo::Interval<int>{q}, static_cast<int>(i));
+                   tree.query(q, ctx, [&](const auto& interval, const auto& value) { matches++; });
+                   if (auto node = tree.search(q)) {
+                       tree.remove(node);
+                   }
+                   tree.query(q, ctx, [&](const auto& interval, const auto& value) { matches++; });
+               }
+           }));
+
+    report(distribution, "remove", n, measure(n, [&] {
+               for (const auto& interval : intervals) {
+                   if (auto node = tree.search(interval)) {
+                       tree.remove(node);
+                   }
+               }
+           }));
+
+    // Keep side effects observable so the loops cannot be optimized away.
+    std::cout << "# " << distribution << " matches=" << matches << " hits=" << hits
+              << " final_size=" << tree.size() << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::size_t n = argc > 1 ? std::stoull(argv[1]) : 100'000;
+    std::size_t num_queries = argc > 2 ? std::stoull(argv[2]) : 100'000;
+    for (const std::string& distribution : {"uniform", "clustered", "nested"}) {
+        run(distribution, n, num_queries);
+    }
+    return 0;
+}
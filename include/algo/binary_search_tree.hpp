@@ -35,6 +35,34 @@ public:
 
     void remove(const T& key);
 
+    // Node-handle API: one descent to locate a node, then O(1)-lookup
+    // removal, extraction, and re-insertion without a second search or any
+    // reallocation. Handles are invalidated by removal of the node they
+    // point to. NodeHandle owns an extracted node like std::map::extract;
+    // rekey it via setKey() before handing it back to insert(). Not for
+    // subclasses that maintain extra invariants on remove — these paths
+    // skip their fixups, which is why RedBlackTree deletes them.
+    using NodeHandle = std::unique_ptr<Node>;
+
+    const Node* find(const T& key) const { return search(key); }
+    Node* find(const T& key) { return search(key); }
+
+    void remove(Node* node) { internal_remove(node); }
+
+    NodeHandle extract(Node* node) {
+        NodeHandle handle = internal_remove(node);
+        if (handle) {
+            handle->unlink();
+        }
+        return handle;
+    }
+
+    void insert(NodeHandle&& node) {
+        if (node) {
+            internal_add(std::move(node));
+        }
+    }
+
     bool isBST() const;
 
     int size() const { return sz_; }
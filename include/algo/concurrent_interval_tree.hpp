@@ -0,0 +1,252 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "interval_tree.hpp"
+
+namespace algo {
+
+namespace internal {
+
+// Arena policy that defers destruction: destroy() only parks the node on a
+// retire list, and the owner decides when it is actually safe to free it.
+// Readers that still hold pointers into the tree therefore never observe a
+// destroyed node.
+template <typename T>
+class RetiringArena {
+public:
+    template <typename... Args>
+    T* create(Args&&... args) {
+        return base_.create(std::forward<Args>(args)...);
+    }
+
+    void destroy(T* node) { retired_.push_back(node); }
+
+    void reset() {
+        for (auto node : retired_) {
+            node->~T();
+        }
+        retired_.clear();
+        base_.reset();
+    }
+
+    std::vector<T*>& retired() { return retired_; }
+
+    void reclaim(T* node) { base_.destroy(node); }
+
+private:
+    NodeArena<T> base_;
+    std::vector<T*> retired_;
+};
+
+}  // namespace internal
+
+// Single-writer / many-reader wrapper around IntervalTree.
+//
+// Writers (insert/remove) serialize on an internal mutex. Readers run
+// lock-free: a walk traverses the tree optimistically, buffers its matches,
+// and only delivers them if the tree version did not change underneath it —
+// otherwise it retries (and after a few torn attempts falls back to taking
+// the writer lock, so progress is guaranteed). Nodes unlinked by remove()
+// are stamped with the current epoch and reclaimed only once every active
+// reader has entered a later epoch, so a concurrent reader can never touch
+// freed memory.
+//
+// Each reading thread needs its own Reader handle (see reader()); V must be
+// copyable since matches are buffered before delivery.
+template <typename K, typename V>
+class ConcurrentIntervalTree {
+public:
+    using Tree = IntervalTree<K, V, internal::RetiringArena<IntervalTreeNode<K, V>>>;
+    using Node = IntervalTreeNode<K, V>;
+
+    static constexpr std::size_t kMaxReaders = 64;
+
+    ConcurrentIntervalTree() {
+        for (auto& slot : slots_) {
+            slot.store(kFreeSlot, std::memory_order_relaxed);
+        }
+    }
+
+    // No readers may be active once destruction starts.
+    ~ConcurrentIntervalTree() = default;
+
+    ConcurrentIntervalTree(const ConcurrentIntervalTree&) = delete;
+    ConcurrentIntervalTree& operator=(const ConcurrentIntervalTree&) = delete;
+
+    class Reader {
+    public:
+        ~Reader() {
+            if (slot_) {
+                slot_->store(kFreeSlot, std::memory_order_release);
+            }
+        }
+
+        Reader(Reader&& reader) noexcept
+            : tree_(reader.tree_), slot_(std::exchange(reader.slot_, nullptr)) {}
+
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+        Reader& operator=(Reader&&) = delete;
+
+        template <typename Function>
+        void walk(const Interval<K>& interval, Function&& func) {
+            buffer_.clear();
+            for (int attempt = 0; attempt < kMaxOptimisticAttempts; attempt++) {
+                slot_->store(tree_->epoch_.load(std::memory_order_seq_cst),
+                             std::memory_order_seq_cst);
+                std::uint64_t v1 = tree_->seq_.load(std::memory_order_acquire);
+                bool ok = (v1 & 1) == 0 && tree_->collect(interval, buffer_);
+                std::uint64_t v2 = tree_->seq_.load(std::memory_order_acquire);
+                slot_->store(kIdle, std::memory_order_release);
+                if (ok && v1 == v2) {
+                    deliver(func);
+                    return;
+                }
+                buffer_.clear();
+            }
+            // Torn too many times; read a quiescent tree under the lock.
+            {
+                std::lock_guard<std::mutex> guard(tree_->writer_mutex_);
+                tree_->collect(interval, buffer_);
+            }
+            deliver(func);
+        }
+
+    private:
+        friend class ConcurrentIntervalTree;
+
+        static constexpr int kMaxOptimisticAttempts = 16;
+
+        Reader(ConcurrentIntervalTree* tree, std::atomic<std::uint64_t>* slot)
+            : tree_(tree), slot_(slot) {}
+
+        template <typename Function>
+        void deliver(Function&& func) {
+            for (const auto& match : buffer_) {
+                func(match.first, match.second);
+            }
+        }
+
+        ConcurrentIntervalTree* tree_;
+        std::atomic<std::uint64_t>* slot_;
+        std::vector<std::pair<Interval<K>, V>> buffer_;
+    };
+
+    // Registers the calling thread as a reader. Holds one of kMaxReaders
+    // slots until the Reader is destroyed.
+    Reader reader() {
+        for (auto& slot : slots_) {
+            std::uint64_t expected = kFreeSlot;
+            if (slot.compare_exchange_strong(expected, kIdle, std::memory_order_acq_rel)) {
+                return Reader(this, &slot);
+            }
+        }
+        assert(false && "Too many concurrent readers");
+        return Reader(this, nullptr);
+    }
+
+    void insert(Interval<K>&& interval, V value) {
+        std::lock_guard<std::mutex> guard(writer_mutex_);
+        seq_.fetch_add(1, std::memory_order_acq_rel);
+        tree_.insert(std::move(interval), std::move(value));
+        size_.fetch_add(1, std::memory_order_relaxed);
+        seq_.fetch_add(1, std::memory_order_release);
+        retire_and_reclaim();
+    }
+
+    // Removes one interval overlapping `interval`; returns whether one existed.
+    bool remove_overlap(const Interval<K>& interval) {
+        std::lock_guard<std::mutex> guard(writer_mutex_);
+        auto node = tree_.search(interval);
+        if (node == nullptr) {
+            return false;
+        }
+        seq_.fetch_add(1, std::memory_order_acq_rel);
+        tree_.remove(node);
+        size_.fetch_sub(1, std::memory_order_relaxed);
+        seq_.fetch_add(1, std::memory_order_release);
+        retire_and_reclaim();
+        return true;
+    }
+
+    std::size_t size() const { return size_.load(std::memory_order_relaxed); }
+
+private:
+    friend class Reader;
+
+    static constexpr std::uint64_t kFreeSlot = UINT64_MAX;
+    static constexpr std::uint64_t kIdle = UINT64_MAX - 1;
+
+    // Optimistic traversal into `out`. Returns false if the walk had to give
+    // up (stack overflow or visit budget exhausted on a torn tree); the
+    // caller revalidates against seq_ anyway.
+    bool collect(const Interval<K>& interval, std::vector<std::pair<Interval<K>, V>>& out) const {
+        const Node* stack[kMaxDepth];
+        std::size_t top = 0;
+        std::size_t budget = 2 * size_.load(std::memory_order_relaxed) + 64;
+        const Node* node = tree_.root_;
+        for (;;) {
+            while (node) {
+                if (top == kMaxDepth || budget-- == 0) {
+                    return false;
+                }
+                stack[top++] = node;
+                node = (node->left_ && interval.low_ <= node->left_->max_) ? node->left_ : nullptr;
+            }
+            if (top == 0) {
+                return true;
+            }
+            node = stack[--top];
+            if (node->interval_.overlap(interval)) {
+                out.emplace_back(node->interval_, node->value_);
+            }
+            node = (node->right_ && node->key() <= interval.high_ && interval.low_ <= node->right_->max_) ? node->right_ : nullptr;
+        }
+    }
+
+    // Called under writer_mutex_. Stamps nodes unlinked by the last mutation
+    // with the current epoch, advances it, and frees retired nodes every
+    // active reader has moved past.
+    void retire_and_reclaim() {
+        std::uint64_t epoch = epoch_.load(std::memory_order_relaxed);
+        for (auto node : tree_.arena_.retired()) {
+            retired_.emplace_back(node, epoch);
+        }
+        tree_.arena_.retired().clear();
+        epoch_.fetch_add(1, std::memory_order_seq_cst);
+
+        std::uint64_t min_active = UINT64_MAX;
+        for (const auto& slot : slots_) {
+            std::uint64_t value = slot.load(std::memory_order_seq_cst);
+            if (value < kIdle) {
+                min_active = std::min(min_active, value);
+            }
+        }
+        std::size_t kept = 0;
+        for (auto& entry : retired_) {
+            if (entry.second < min_active) {
+                tree_.arena_.reclaim(entry.first);
+            } else {
+                retired_[kept++] = entry;
+            }
+        }
+        retired_.resize(kept);
+    }
+
+    static constexpr std::size_t kMaxDepth = 96;
+
+    Tree tree_;
+    std::mutex writer_mutex_;
+    std::atomic<std::uint64_t> seq_{0};
+    std::atomic<std::uint64_t> epoch_{0};
+    std::atomic<std::size_t> size_{0};
+    std::atomic<std::uint64_t> slots_[kMaxReaders];
+    std::vector<std::pair<Node*, std::uint64_t>> retired_;
+};
+
+}  // namespace algo
@@ -0,0 +1,344 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "interval_tree.hpp"
+
+namespace algo {
+
+namespace internal {
+
+constexpr std::uint32_t kFrozenNull = UINT32_MAX;
+
+// Red-black trees with 32-bit indices hold < 2^32 nodes, whose height is
+// bounded by 2*log2(2^32) = 64.
+constexpr std::size_t kFrozenMaxDepth = 64;
+
+// Shared traversals over a flat, index-linked node array; used by both the
+// in-memory FrozenIntervalTree and the mmap-backed MappedIntervalTree.
+// Same visit order and pruning as IntervalTree::walk, including the
+// bool-returning early-termination protocol.
+template <typename K, typename NodeT, typename Function>
+void frozen_walk(const NodeT* nodes, std::size_t count, const Interval<K>& interval,
+                 Function&& func) {
+    std::uint32_t stack[kFrozenMaxDepth];
+    std::size_t top = 0;
+    std::uint32_t index = count == 0 ? kFrozenNull : 0;
+    for (;;) {
+        while (index != kFrozenNull) {
+            stack[top++] = index;
+            auto left = nodes[index].left_;
+            index = (left != kFrozenNull && interval.low_ <= nodes[left].max_) ? left : kFrozenNull;
+        }
+        if (top == 0) {
+            break;
+        }
+        index = stack[--top];
+        const NodeT& node = nodes[index];
+        if (node.interval_.overlap(interval)) {
+            if constexpr (std::is_void_v<decltype(func(node.interval_, node.value_))>) {
+                func(node.interval_, node.value_);
+            } else if (!func(node.interval_, node.value_)) {
+                return;
+            }
+        }
+        auto right = node.right_;
+        index = (right != kFrozenNull && node.interval_.key() <= interval.high_ &&
+                 interval.low_ <= nodes[right].max_)
+                    ? right
+                    : kFrozenNull;
+    }
+}
+
+// Same descent as IntervalTree::search; returns any overlapping node.
+template <typename K, typename NodeT>
+const NodeT* frozen_search(const NodeT* nodes, std::size_t count, const Interval<K>& interval) {
+    std::uint32_t index = count == 0 ? kFrozenNull : 0;
+    while (index != kFrozenNull && !nodes[index].interval_.overlap(interval)) {
+        auto left = nodes[index].left_;
+        if (left != kFrozenNull && nodes[left].max_ >= interval.low_) {
+            index = left;
+        } else {
+            index = nodes[index].right_;
+        }
+    }
+    return index == kFrozenNull ? nullptr : &nodes[index];
+}
+
+// Runs every query in `queries` against the flat node array using
+// `thread_count` worker threads and fills `results[i]` with the matches of
+// queries[i]. Queries are handed out in small chunks through one atomic
+// cursor, so a thread that drew cheap queries immediately grabs more while
+// a thread stuck in a dense region keeps crunching — skewed overlap counts
+// do not idle cores the way a static split does. Each query owns a distinct
+// results slot, so workers never contend on output. Sorting the queries
+// beforehand helps (neighboring queries touch the same subtrees) but is not
+// required.
+template <typename K, typename NodeT, typename V>
+void frozen_parallel_walk_all(const NodeT* nodes, std::size_t count,
+                              const std::vector<Interval<K>>& queries,
+                              std::vector<std::vector<std::pair<Interval<K>, V>>>& results,
+                              unsigned thread_count) {
+    // Large enough to amortize the atomic, small enough to rebalance skew.
+    constexpr std::size_t kChunk = 32;
+    results.assign(queries.size(), {});
+    std::size_t want = (queries.size() + kChunk - 1) / kChunk;
+    std::size_t workers = std::min<std::size_t>(thread_count ? thread_count : 1, want);
+    if (workers <= 1) {
+        for (std::size_t i = 0; i < queries.size(); i++) {
+            frozen_walk(nodes, count, queries[i], [&](const auto& interval, const auto& value) {
+                results[i].emplace_back(interval, value);
+            });
+        }
+        return;
+    }
+    std::atomic<std::size_t> cursor{0};
+    auto work = [&] {
+        for (;;) {
+            std::size_t first = cursor.fetch_add(kChunk, std::memory_order_relaxed);
+            if (first >= queries.size()) {
+                return;
+            }
+            std::size_t last = std::min(first + kChunk, queries.size());
+            for (std::size_t i = first; i < last; i++) {
+                frozen_walk(nodes, count, queries[i],
+                            [&](const auto& interval, const auto& value) {
+                                results[i].emplace_back(interval, value);
+                            });
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+    for (std::size_t t = 1; t < workers; t++) {
+        threads.emplace_back(work);
+    }
+    work();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+// On-disk snapshot header; node records follow as raw fixed-width copies.
+struct FrozenSnapshotHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t node_size;
+    std::uint64_t count;
+};
+
+constexpr char kFrozenMagic[8] = {'a', 'l', 'g', 'o', 'i', 't', 'r', 'e'};
+constexpr std::uint32_t kFrozenVersion = 1;
+
+}  // namespace internal
+
+// Read-optimized snapshot of an IntervalTree. Nodes are packed into one
+// contiguous vector in BFS order and linked by 32-bit indices instead of
+// pointers; parent links and colors are dropped since the snapshot is
+// immutable. Queries run the same pruning logic as IntervalTree::walk and
+// search but chase half as much pointer data, and sibling nodes of a level
+// share cache lines.
+template <typename K, typename V>
+class FrozenIntervalTree {
+public:
+    static constexpr std::uint32_t kNull = internal::kFrozenNull;
+
+    struct Node {
+        Interval<K> interval_;
+        K max_;
+        std::uint32_t left_ = kNull;
+        std::uint32_t right_ = kNull;
+        V value_;
+    };
+
+    FrozenIntervalTree() = default;
+
+    template <typename Arena>
+    explicit FrozenIntervalTree(const IntervalTree<K, V, Arena>& tree) {
+        std::size_t count = 0;
+        tree.inorder([&](const auto& interval, const auto& value) { count++; });
+        nodes_.reserve(count);
+        if (tree.root_ == nullptr) {
+            return;
+        }
+        // BFS: parents are laid out before (and near) their children, so the
+        // top levels of the tree share a handful of cache lines.
+        std::vector<const IntervalTreeNode<K, V>*> level{tree.root_};
+        std::vector<const IntervalTreeNode<K, V>*> next;
+        while (!level.empty()) {
+            for (auto live : level) {
+                auto& node = nodes_.emplace_back();
+                node.interval_ = live->interval_;
+                node.max_ = live->max_;
+                node.value_ = live->value_;
+            }
+            std::uint32_t child = static_cast<std::uint32_t>(nodes_.size());
+            std::uint32_t parent = child - static_cast<std::uint32_t>(level.size());
+            next.clear();
+            for (auto live : level) {
+                if (live->left_) {
+                    nodes_[parent].left_ = child++;
+                    next.push_back(live->left_);
+                }
+                if (live->right_) {
+                    nodes_[parent].right_ = child++;
+                    next.push_back(live->right_);
+                }
+                parent++;
+            }
+            std::swap(level, next);
+        }
+    }
+
+    std::size_t size() const { return nodes_.size(); }
+    bool empty() const { return nodes_.empty(); }
+
+    template <typename Function>
+    void walk(const Interval<K>& interval, Function&& func) const {
+        internal::frozen_walk(nodes_.data(), nodes_.size(), interval,
+                              std::forward<Function>(func));
+    }
+
+    const Node* search(const Interval<K>& interval) const {
+        return internal::frozen_search(nodes_.data(), nodes_.size(), interval);
+    }
+
+    // Answers a whole batch of queries on `thread_count` threads;
+    // results[i] receives the matches of queries[i]. See
+    // internal::frozen_parallel_walk_all for the scheduling scheme.
+    void parallel_walk_all(const std::vector<Interval<K>>& queries,
+                           std::vector<std::vector<std::pair<Interval<K>, V>>>& results,
+                           unsigned thread_count = std::thread::hardware_concurrency()) const {
+        internal::frozen_parallel_walk_all<K, Node, V>(nodes_.data(), nodes_.size(), queries,
+                                                       results, thread_count);
+    }
+
+    // Writes the snapshot as a versioned flat binary file that
+    // MappedIntervalTree can serve queries from without deserialization.
+    // Only trivially copyable K/V have a well-defined on-disk form.
+    void save(const std::string& path) const {
+        static_assert(std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>,
+                      "snapshot format requires trivially copyable key and value types");
+        internal::FrozenSnapshotHeader header;
+        std::memcpy(header.magic, internal::kFrozenMagic, sizeof(header.magic));
+        header.version = internal::kFrozenVersion;
+        header.node_size = sizeof(Node);
+        header.count = nodes_.size();
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Cannot open snapshot file for writing: " + path);
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(nodes_.data()),
+                  static_cast<std::streamsize>(nodes_.size() * sizeof(Node)));
+        if (!out) {
+            throw std::runtime_error("Short write while saving snapshot: " + path);
+        }
+    }
+
+private:
+    std::vector<Node> nodes_;
+};
+
+// Serves queries straight out of a memory-mapped snapshot produced by
+// FrozenIntervalTree::save: no parsing, no per-node allocation, no pointer
+// fixup — load cost is one mmap, pages fault in on demand, and multiple
+// processes mapping the same file share one page-cache copy.
+template <typename K, typename V>
+class MappedIntervalTree {
+public:
+    using Node = typename FrozenIntervalTree<K, V>::Node;
+
+    explicit MappedIntervalTree(const std::string& path) {
+        static_assert(std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>,
+                      "snapshot format requires trivially copyable key and value types");
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("Cannot open snapshot file: " + path);
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(internal::FrozenSnapshotHeader)) {
+            ::close(fd);
+            throw std::runtime_error("Snapshot file truncated: " + path);
+        }
+        map_size_ = static_cast<std::size_t>(st.st_size);
+        void* map = ::mmap(nullptr, map_size_, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (map == MAP_FAILED) {
+            throw std::runtime_error("Cannot mmap snapshot file: " + path);
+        }
+        map_ = map;
+        const auto* header = static_cast<const internal::FrozenSnapshotHeader*>(map_);
+        // The bounds check divides instead of multiplying: count is a raw
+        // uint64 from the file, and `count * sizeof(Node)` would wrap for a
+        // corrupt value, pass the check, and send queries past the mapping.
+        if (std::memcmp(header->magic, internal::kFrozenMagic, sizeof(header->magic)) != 0 ||
+            header->version != internal::kFrozenVersion || header->node_size != sizeof(Node) ||
+            header->count > (map_size_ - sizeof(internal::FrozenSnapshotHeader)) / sizeof(Node)) {
+            ::munmap(map_, map_size_);
+            map_ = nullptr;
+            throw std::runtime_error("Snapshot file has incompatible format: " + path);
+        }
+        count_ = static_cast<std::size_t>(header->count);
+        nodes_ = reinterpret_cast<const Node*>(static_cast<const char*>(map_) +
+                                               sizeof(internal::FrozenSnapshotHeader));
+    }
+
+    ~MappedIntervalTree() {
+        if (map_) {
+            ::munmap(map_, map_size_);
+        }
+    }
+
+    MappedIntervalTree(MappedIntervalTree&& tree) noexcept
+        : map_(std::exchange(tree.map_, nullptr)),
+          map_size_(std::exchange(tree.map_size_, 0)),
+          nodes_(std::exchange(tree.nodes_, nullptr)),
+          count_(std::exchange(tree.count_, 0)) {}
+
+    MappedIntervalTree(const MappedIntervalTree&) = delete;
+    MappedIntervalTree& operator=(const MappedIntervalTree&) = delete;
+    MappedIntervalTree& operator=(MappedIntervalTree&&) = delete;
+
+    std::size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+    template <typename Function>
+    void walk(const Interval<K>& interval, Function&& func) const {
+        internal::frozen_walk(nodes_, count_, interval, std::forward<Function>(func));
+    }
+
+    const Node* search(const Interval<K>& interval) const {
+        return internal::frozen_search(nodes_, count_, interval);
+    }
+
+    void parallel_walk_all(const std::vector<Interval<K>>& queries,
+                           std::vector<std::vector<std::pair<Interval<K>, V>>>& results,
+                           unsigned thread_count = std::thread::hardware_concurrency()) const {
+        internal::frozen_parallel_walk_all<K, Node, V>(nodes_, count_, queries, results,
+                                                       thread_count);
+    }
+
+private:
+    void* map_ = nullptr;
+    std::size_t map_size_ = 0;
+    const Node* nodes_ = nullptr;
+    std::size_t count_ = 0;
+};
+
+}  // namespace algo
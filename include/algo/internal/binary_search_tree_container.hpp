@@ -63,12 +63,107 @@ public:
 
     void setValue(Value&& value) { value_ = std::move(value); }
 
+    // Only meaningful on a node extracted from its tree: rekeying a linked
+    // node would break the search order.
+    void setKey(Key&& key) { key_ = std::move(key); }
+
+    // Clears this node's links without touching the nodes they point to;
+    // used when the node leaves the tree while its old neighbors live on.
+    void unlink() {
+        left_ = nullptr;
+        right_ = nullptr;
+        parent_ = nullptr;
+    }
+
+protected:
+    Node* left_;
+    Node* right_;
+    Node* parent_;
+    Key key_;
+    Value value_;
+};
+
+// Node for the self-balancing RedBlackTree: the BinarySearchTreeNode
+// interface plus the color bit the rebalancing fixups need. A separate
+// class (BinarySearchTreeNode is final) so the plain tree pays nothing
+// for the flag.
+template <typename Key, typename Value>
+class RedBlackTreeNode final {
+public:
+    using Node = RedBlackTreeNode<Key, Value>;
+
+    template <typename... Args>
+    explicit RedBlackTreeNode(Key&& key, Args&&... args)
+        : left_(nullptr), right_(nullptr), parent_(nullptr), key_(std::move(key)), value_(std::forward<Args>(args)...) {}
+
+    const Node* left() const { return left_; }
+    Node* left() { return left_; }
+
+    const Node* right() const { return right_; }
+    Node* right() { return right_; }
+
+    void setLeft(Node* node) {
+        left_ = node;
+        if (left_) {
+            left_->setParent(this);
+        }
+    }
+
+    void setRight(Node* node) {
+        right_ = node;
+        if (right_) {
+            right_->setParent(this);
+        }
+    }
+
+    Node* takeLeft() {
+        auto old_left = left_;
+        left_ = nullptr;
+        if (old_left) {
+            old_left->setParent(nullptr);
+        }
+        return old_left;
+    }
+
+    Node* takeRight() {
+        auto old_right = right_;
+        right_ = nullptr;
+        if (old_right) {
+            old_right->setParent(nullptr);
+        }
+        return old_right;
+    }
+
+    const Node* parent() const { return parent_; }
+    Node* parent() { return parent_; }
+
+    void setParent(Node* parent) { parent_ = parent; }
+
+    const Key& key() const { return key_; }
+
+    const Value& value() const { return value_; }
+    Value& value() { return value_; }
+
+    void setValue(Value&& value) { value_ = std::move(value); }
+
+    void setKey(Key&& key) { key_ = std::move(key); }
+
+    void unlink() {
+        left_ = nullptr;
+        right_ = nullptr;
+        parent_ = nullptr;
+    }
+
+    bool isRed() const { return is_red_; }
+    void setRed(bool red) { is_red_ = red; }
+
 protected:
     Node* left_;
     Node* right_;
     Node* parent_;
     Key key_;
     Value value_;
+    bool is_red_ = true;  // fresh nodes are red; fixups recolor
 };
 
 }  // namespace algo::internal
\ No newline at end of file
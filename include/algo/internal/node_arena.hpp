@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace algo::internal {
+
+// Slab allocator for fixed-size tree nodes. Nodes are carved out of large
+// contiguous blocks instead of being malloc'd one by one; destroyed nodes go
+// onto a free list and are reused by later allocations, and reset() drops
+// every block in one step.
+template <typename T>
+class NodeArena {
+public:
+    NodeArena() noexcept = default;
+    ~NodeArena() = default;
+
+    NodeArena(NodeArena&& arena) noexcept
+        : blocks_(std::move(arena.blocks_)),
+          free_list_(std::exchange(arena.free_list_, nullptr)),
+          next_(std::exchange(arena.next_, 0)) {}
+
+    NodeArena& operator=(NodeArena&& arena) noexcept {
+        if (this != &arena) {
+            blocks_ = std::move(arena.blocks_);
+            free_list_ = std::exchange(arena.free_list_, nullptr);
+            next_ = std::exchange(arena.next_, 0);
+        }
+        return *this;
+    }
+
+    NodeArena(const NodeArena& arena) = delete;
+    NodeArena& operator=(const NodeArena& arena) = delete;
+
+    template <typename... Args>
+    T* create(Args&&... args) {
+        return new (allocate()) T(std::forward<Args>(args)...);
+    }
+
+    void destroy(T* node) {
+        node->~T();
+        recycle(node);
+    }
+
+    // Returns a node's slot to the free list without running its destructor.
+    void recycle(T* node) {
+        auto slot = reinterpret_cast<Slot*>(node);
+        slot->next_free = free_list_;
+        free_list_ = slot;
+    }
+
+    // Releases every block at once. All nodes must already be destroyed (or
+    // be trivially destructible); pointers into the arena become invalid.
+    void reset() {
+        blocks_.clear();
+        free_list_ = nullptr;
+        next_ = 0;
+    }
+
+private:
+    union Slot {
+        Slot* next_free;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    static constexpr std::size_t kBlockSize = 1024;
+
+    void* allocate() {
+        if (free_list_) {
+            Slot* slot = free_list_;
+            free_list_ = slot->next_free;
+            return slot;
+        }
+        if (blocks_.empty() || next_ == kBlockSize) {
+            blocks_.push_back(std::make_unique<Slot[]>(kBlockSize));
+            next_ = 0;
+        }
+        return &blocks_.back()[next_++];
+    }
+
+    std::vector<std::unique_ptr<Slot[]>> blocks_;
+    Slot* free_list_ = nullptr;
+    std::size_t next_ = 0;
+};
+
+}  // namespace algo::internal
@@ -0,0 +1,62 @@
+#pragma once
+
+// Opt-in instrumentation for IntervalTree queries. Define
+// ALGO_INTERVAL_TREE_STATS at build time to accumulate per-thread counters
+// (nodes touched, deepest descent, subtree prunes taken through the max_
+// test, matches delivered) that can be sampled via algo::query_stats() and
+// cleared with reset(). When the macro is not defined every hook expands to
+// nothing — no branches, no atomics, no TLS reads on the hot path.
+
+#ifdef ALGO_INTERVAL_TREE_STATS
+
+#include <cstdint>
+
+namespace algo {
+
+struct QueryStats {
+    std::uint64_t nodes_visited = 0;
+    std::uint64_t max_depth = 0;
+    std::uint64_t prunes = 0;
+    std::uint64_t matches = 0;
+    std::uint64_t depth = 0;  // live descent depth, transient within a query
+
+    void enter() {
+        nodes_visited++;
+        depth++;
+        if (depth > max_depth) {
+            max_depth = depth;
+        }
+    }
+
+    void leave() { depth--; }
+
+    void reset() { *this = QueryStats{}; }
+};
+
+// One counter block per thread; workers never contend.
+inline QueryStats& query_stats() {
+    thread_local QueryStats stats;
+    return stats;
+}
+
+namespace internal {
+
+// Pairs enter/leave around one node visit in recursive traversals.
+struct QueryStatsScope {
+    QueryStatsScope() { query_stats().enter(); }
+    ~QueryStatsScope() { query_stats().leave(); }
+};
+
+}  // namespace internal
+
+}  // namespace algo
+
+#define ALGO_ITREE_STAT(call) (algo::query_stats().call)
+#define ALGO_ITREE_STAT_SCOPE() algo::internal::QueryStatsScope algo_itree_stat_scope_
+
+#else
+
+#define ALGO_ITREE_STAT(call) ((void)0)
+#define ALGO_ITREE_STAT_SCOPE() ((void)0)
+
+#endif
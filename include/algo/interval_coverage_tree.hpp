@@ -0,0 +1,72 @@
+#pragma once
+
+#include "interval_tree.hpp"
+
+namespace algo {
+
+// Answers "how many stored intervals cover point p" in O(log n) no matter
+// how many actually do, where walk({p, p}, ...) pays O(log n + k) with k
+// often in the hundreds. A closed interval [low, high] covers p exactly
+// when low <= p and p <= high, so the coverage at p is
+//
+//     #(low_ <= p)  -  #(high_ < p)
+//
+// Both terms are rank queries over a single endpoint multiset, so the tree
+// keeps the lows and the highs in two order-statistic IntervalTrees (as
+// degenerate [x, x] entries, each carrying its opposite endpoint as the
+// value) and never has to touch the covering intervals themselves.
+template <typename K>
+class IntervalCoverageTree {
+public:
+    void insert(const Interval<K>& interval) {
+        starts_.insert({interval.low_, interval.low_}, interval.high_);
+        ends_.insert({interval.high_, interval.high_}, interval.low_);
+    }
+
+    // Removes one interval with these exact endpoints; returns false (and
+    // changes nothing) if none is stored.
+    bool remove(const Interval<K>& interval) {
+        auto start = find_entry(starts_, interval.low_, interval.high_);
+        if (start == nullptr) {
+            return false;
+        }
+        // insert() always adds both halves, so the matching end entry exists.
+        auto end = find_entry(ends_, interval.high_, interval.low_);
+        starts_.remove(start);
+        ends_.remove(end);
+        return true;
+    }
+
+    // Number of stored intervals [low, high] with low <= point <= high.
+    std::size_t coverage(const K& point) const {
+        return starts_.rank_leq(point) - ends_.rank(point);
+    }
+
+    std::size_t size() const { return starts_.size(); }
+    bool empty() const { return starts_.size() == 0; }
+
+private:
+    using EndpointTree = IntervalTree<K, K>;
+
+    // Finds the entry with this exact key whose value is `partner`. rank()
+    // lands on the first entry with the key; duplicates are inorder
+    // neighbors, so kth steps through them until the partner matches.
+    static typename EndpointTree::Node* find_entry(EndpointTree& tree, const K& key,
+                                                   const K& partner) {
+        for (std::size_t i = tree.rank(key); i < tree.size(); i++) {
+            auto node = tree.kth(i);
+            if (key < node->key()) {
+                break;
+            }
+            if (node->value_ == partner) {
+                return node;
+            }
+        }
+        return nullptr;
+    }
+
+    EndpointTree starts_;
+    EndpointTree ends_;
+};
+
+}  // namespace algo
@@ -1,22 +1,35 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <utility>
 #include <vector>
 #include <cassert>
 #include <iostream>
 #include <limits>
+#include <numeric>
+#include <type_traits>
+
+#include "internal/node_arena.hpp"
+#include "internal/query_stats.hpp"
 
 namespace algo {
 
 template <typename T>
 struct Interval {
-    bool overlap(const Interval& other) const {
+    constexpr bool overlap(const Interval& other) const {
         // to make it half open change less_equal ('<=') to less ('<')
-        return low_ <= other.high_ && other.low_ <= high_;
+        if constexpr (std::is_integral_v<T>) {
+            // Integer compares are cheap, so evaluate both and combine with
+            // a bitwise AND: no short-circuit branch for adversarial
+            // interval mixes to mispredict in walk's inner loop.
+            return (low_ <= other.high_) & (other.low_ <= high_);
+        } else {
+            return low_ <= other.high_ && other.low_ <= high_;
+        }
     }
 
-    T key() const {
+    constexpr T key() const {
         return low_;
     }
 
@@ -28,27 +41,54 @@ struct Interval {
 template <typename K, typename V>
 class IntervalTreeNode {
 public:
+    IntervalTreeNode() = default;
+
+    // Constructs the node in place so the interval and value are never
+    // default-initialized first and assigned over afterwards.
+    IntervalTreeNode(Interval<K>&& interval, V&& value)
+        : max_(interval.high_), interval_(std::move(interval)), value_(std::move(value)) {}
+
     K key() const { return interval_.key(); }
 
     IntervalTreeNode<K, V>* left_ = nullptr;
     IntervalTreeNode<K, V>* right_ = nullptr;
     IntervalTreeNode<K, V>* parent_ = nullptr;
     K max_;
+    std::size_t count_ = 1;  // nodes in the subtree rooted here, incl. this one
     bool is_red_ = true;
     Interval<K> interval_;
     V value_;
 };
 
-template <typename K, typename V>
+template <typename K, typename V, typename Arena = internal::NodeArena<IntervalTreeNode<K, V>>>
 class IntervalTree {
 public:
     using Node = IntervalTreeNode<K, V>;
 
     IntervalTree() noexcept : root_(nullptr) {}
+
+    // Bulk-load: sorts the batch once and builds a balanced tree bottom-up,
+    // which is much cheaper than one insert() (and one fixup) per interval.
+    explicit IntervalTree(std::vector<std::pair<Interval<K>, V>>&& items) : IntervalTree() {
+        std::sort(items.begin(), items.end(), [](const auto& a, const auto& b) {
+            return a.first.key() < b.first.key();
+        });
+        build_from_sorted(std::move(items));
+    }
+
     ~IntervalTree() { cleanup(); }
 
-    IntervalTree(IntervalTree&& tree) noexcept = default;
-    IntervalTree& operator=(IntervalTree&& tree) noexcept = default;
+    IntervalTree(IntervalTree&& tree) noexcept
+        : root_(std::exchange(tree.root_, nullptr)), arena_(std::move(tree.arena_)) {}
+
+    IntervalTree& operator=(IntervalTree&& tree) noexcept {
+        if (this != &tree) {
+            cleanup();
+            root_ = std::exchange(tree.root_, nullptr);
+            arena_ = std::move(tree.arena_);
+        }
+        return *this;
+    }
 
     IntervalTree(const IntervalTree& tree) = delete;
     IntervalTree& operator=(const IntervalTree& tree) = delete;
@@ -57,65 +97,568 @@ public:
 
     void insert(Interval<K>&& interval, V value);
 
+    // Hinted insert for nearly-sorted streams, like std::map::insert(hint,
+    // ...): pass the node after which the new interval belongs (typically
+    // the previously inserted node) and the comparison-driven descent from
+    // the root is skipped — the node is attached directly next to the hint.
+    // A wrong hint falls back to a normal insert. The subtree counts and
+    // max_ still need their O(height) ancestor update, so the win is the
+    // attach, not a change in asymptotics. Returns the inserted node, which
+    // can serve as the next hint.
+    Node* insert_hint(Node* hint, Interval<K>&& interval, V value);
+
+    // Replaces the current contents with `items`, which must already be
+    // sorted by Interval::key(). Builds a perfectly balanced tree with max_
+    // filled in a single post-order pass and red-black colors assigned by
+    // level, so no fixups or rotations run at all.
+    void build_from_sorted(std::vector<std::pair<Interval<K>, V>>&& items);
+
+    // Burst insert: sorts the batch once, then either rebuilds the whole
+    // tree flat (when the batch rivals the current contents, bulk-load
+    // economics win) or inserts in key order so consecutive descents share
+    // warm path prefixes. Together with the conditional max_ writes in
+    // internal_add this dirties far fewer cache lines than a loop of
+    // individual inserts in arrival order.
+    void insert_batch(std::vector<std::pair<Interval<K>, V>>&& items);
+
+    bool isValid() const;
+
+    std::size_t size() const { return root_ ? root_->count_ : 0; }
+
     Node* search(const Interval<K>& interval);
 
+    // "Does anything overlap?" without callback machinery or a mutable node:
+    // same descent as search(), returns on the first hit. O(log n).
+    bool overlaps(const Interval<K>& interval) const;
+
+    // Number of stored intervals overlapping `interval`, computed from the
+    // subtree counts as #(low_ <= interval.high_) - #(high_ < interval.low_)
+    // instead of visiting each match. The first term is a pure O(log n) rank
+    // walk; the second prunes subtrees through max_ (every high_ below
+    // interval.low_ counts wholesale) and through BST order (every low_ past
+    // interval.high_ contributes nothing), so it descends only subtrees
+    // actually straddling the query — O(log n + k) for k overlaps, not a
+    // full traversal when there are few.
+    std::size_t count_overlaps(const Interval<K>& interval) const;
+
+    // k-th stored interval (0-based) in ascending low_ order, or nullptr if
+    // k >= size(). O(log n) via the subtree counts.
+    Node* kth(std::size_t k);
+
+    // Boundary queries, all O(log n) descents. The low_ endpoints are the
+    // BST keys, so no extra augmentation is needed: the first interval
+    // starting at/after, strictly after, or strictly before `key`.
+    Node* lower_bound(const K& key);
+    Node* next_after(const K& key);
+    Node* prev_before(const K& key);
+
+    // First start g >= from such that the closed window [g, g + width]
+    // overlaps no stored interval. Each blocking interval is skipped with
+    // one O(log n) search, resuming just past its high, so the cost scales
+    // with the blockers crossed. For discrete keys the returned g is the
+    // smallest such start. Requires headroom at the type boundary: from +
+    // width must be representable and no blocking interval may end at
+    // numeric_limits<K>::max(), since there is no start past such a blocker
+    // and the resume arithmetic would overflow (asserted in debug builds).
+    K find_gap(const K& from, const K& width);
+
+    // Number of stored intervals with low_ strictly below `key`. O(log n).
+    std::size_t rank(const K& key) const;
+
+    // Removes every stored interval overlapping `interval` and returns how
+    // many were removed. Small batches are unlinked one by one; when the
+    // matches are a sizable fraction of the tree it is cheaper to move the
+    // survivors out in order and rebuild flat than to run k delete fixups
+    // and k ancestor max_ repairs.
+    std::size_t remove_overlapping(const Interval<K>& interval);
+
+    // Same, but only for intervals lying entirely inside `interval`.
+    std::size_t remove_contained(const Interval<K>& interval);
+
+    // Number of stored intervals with low_ at or below `key`. O(log n).
+    std::size_t rank_leq(const K& key) const;
+
+    // Coalescing insert: finds every stored interval overlapping `interval`
+    // in one traversal, removes them, widens `interval` to cover them, and
+    // inserts the single merged result. merge(acc, other) folds a removed
+    // node's value into `value`. Replaces the search/remove/re-insert loop
+    // callers previously had to run, which paid one O(log n) search per
+    // overlapping node.
+    template <typename Merge>
+    void insert_merging(Interval<K>&& interval, V value, Merge&& merge);
+
     void remove(Node* node);
 
+    // Rebuilds the tree into a freshly reset arena in a single bulk-load
+    // pass. Long insert/remove churn leaves node placement in memory
+    // decorrelated from tree order (remove's transplants recycle slots all
+    // over the arena) and query latency creeps up even at stable n; after a
+    // compact the tree is perfectly balanced and allocated in one
+    // sequential sweep again. Invalidates all node pointers and cursors.
+    void compact();
+
+    // Runs compact() once the removals since the last rebuild rival the
+    // current size (and the tree is big enough for layout to matter).
+    // Returns whether a rebuild ran; call it from maintenance points, e.g.
+    // after a burst of removals.
+    bool maybe_compact();
+
     template <typename Function>
     void inorder(Function&& func) const;
 
+    // The callback may return void (visit everything, as before) or bool:
+    // returning false aborts the traversal immediately, so "first k matches"
+    // queries stop paying for the remaining ones. Applies to walk() and
+    // query() alike; void-returning callbacks compile to exactly the old
+    // code via if constexpr.
     template <typename Function>
     void walk(const Interval<K>& interval, Function&& func) const;
 
+    // Reusable scratch stack for query(). The first kInlineCapacity levels
+    // live inline, so a context kept alive across queries (e.g. one per
+    // thread) never touches the heap for trees up to 2^64 nodes in practice.
+    class QueryContext {
+    public:
+        void clear() { size_ = 0; }
+
+    private:
+        friend class IntervalTree;
+
+        static constexpr std::size_t kInlineCapacity = 128;
+
+        void push(Node* node) {
+            if (size_ < kInlineCapacity) {
+                inline_[size_] = node;
+            } else if (size_ - kInlineCapacity == overflow_.size()) {
+                overflow_.push_back(node);
+            } else {
+                overflow_[size_ - kInlineCapacity] = node;
+            }
+            size_++;
+        }
+
+        Node* pop() {
+            size_--;
+            return size_ < kInlineCapacity ? inline_[size_] : overflow_[size_ - kInlineCapacity];
+        }
+
+        bool empty() const { return size_ == 0; }
+
+        Node* inline_[kInlineCapacity];
+        std::vector<Node*> overflow_;
+        std::size_t size_ = 0;
+    };
+
+    // Iterative equivalent of walk(): visits the same intervals in the same
+    // order, but uses an explicit stack instead of recursion, so deep trees
+    // cannot blow the call stack and a reused context makes it allocation-free.
+    template <typename Function>
+    void query(const Interval<K>& interval, QueryContext& ctx, Function&& func) const;
+
+    template <typename Function>
+    void query(const Interval<K>& interval, Function&& func) const {
+        QueryContext ctx;
+        query(interval, ctx, std::forward<Function>(func));
+    }
+
+    // Runs a burst of stab queries in ascending low_ order with one shared
+    // scratch stack. Consecutive queries traverse largely the same nodes, so
+    // the upper levels of the tree stay cache-resident across the batch
+    // instead of being re-fetched per query. func is called as
+    // func(query_index, interval, value) since results arrive out of the
+    // caller's query order.
+    template <typename Function>
+    void walk_batch(const std::vector<Interval<K>>& queries, Function&& func) const;
+
+    // Bumped by every mutation; lets long-running readers detect that
+    // pointers into the tree went stale.
+    std::uint64_t generation() const { return generation_; }
+
+    // Resumable inorder iteration in chunks, so a full O(n) export can be
+    // interleaved with writes instead of holding the tree for its whole
+    // duration. Between chunks the cursor keeps a node pointer only while
+    // the generation is unchanged; after a mutation it reseeks from the
+    // last delivered key in O(log n) and carries on. With duplicate lows, a
+    // mutation between chunks can skip the remaining entries that share the
+    // last delivered low.
+    class Cursor {
+    public:
+        explicit Cursor(IntervalTree& tree) : tree_(&tree) {}
+
+        // Visits up to n entries as func(interval, value); returns how many
+        // were delivered. Zero means the pass is complete.
+        template <typename Function>
+        std::size_t next(std::size_t n, Function&& func) {
+            if (finished_) {
+                return 0;
+            }
+            if (!started_) {
+                pos_ = tree_->root_ ? tree_->minimum(tree_->root_) : nullptr;
+                started_ = true;
+                generation_ = tree_->generation_;
+            } else if (generation_ != tree_->generation_) {
+                pos_ = tree_->next_after(last_key_);
+                generation_ = tree_->generation_;
+            }
+            std::size_t visited = 0;
+            while (pos_ && visited < n) {
+                func(pos_->interval_, pos_->value_);
+                last_key_ = pos_->key();
+                visited++;
+                pos_ = tree_->successor(pos_);
+            }
+            if (pos_ == nullptr) {
+                finished_ = true;
+            }
+            return visited;
+        }
+
+        bool done() const { return finished_; }
+
+    private:
+        IntervalTree* tree_;
+        Node* pos_ = nullptr;
+        bool started_ = false;
+        bool finished_ = false;
+        std::uint64_t generation_ = 0;
+        K last_key_{};
+    };
+
     std::string print() const;
 
 private:
-    using NodeType = std::unique_ptr<Node>;
+    template <typename, typename>
+    friend class FrozenIntervalTree;
+
+    template <typename, typename>
+    friend class FrozenIntervalTreeSoA;
+
+    template <typename, typename>
+    friend class ConcurrentIntervalTree;
+
+    void internal_add(Node* node);
+
+    void destroy_subtree(Node* node);
 
-    void internal_add(NodeType&& node);
+    Node* build_range(std::vector<std::pair<Interval<K>, V>>& items, std::size_t first,
+                      std::size_t last, std::size_t depth, std::size_t bottom);
 
+    bool validate(const Node* node, int& black_height) const;
+
+    void fix_local_violation(Node* node);
     void rb_insert_fixup(Node* node);
-    void rb_delete_fixup(Node* x);
+    void rb_delete_fixup(Node* x, Node* parent);
 
     Node* minimum(Node* node);
+    Node* successor(Node* node);
 
     void transplant(Node* u, Node* v);
 
     void left_rotate(Node* x);
     void right_rotate(Node* x);
 
+    void recompute_max(Node* x);
+    void update_max_upward(Node* node);
+
+    void collect_overlapping(const Interval<K>& interval, std::vector<Node*>& out);
+
+    // Number of intervals under `node` with high_ < bound, among those with
+    // low_ <= cap. Requires bound <= cap; callers pass a query's low/high,
+    // and intervals with low_ > cap have high_ >= bound by transitivity, so
+    // skipping them never drops a countable entry.
+    std::size_t count_high_below(const Node* node, const K& bound, const K& cap) const;
+
+    // Invokes the visitor and reports whether the traversal should continue.
+    template <typename Function>
+    static bool visit(Function&& func, const Interval<K>& interval, const V& value) {
+        if constexpr (std::is_void_v<decltype(func(interval, value))>) {
+            func(interval, value);
+            return true;
+        } else {
+            return static_cast<bool>(func(interval, value));
+        }
+    }
+
     template <typename Function>
     void inorder(Node* node, Function&& func) const;
 
     template <typename Function>
-    void walk(Node* node, const Interval<K>& interval, Function&& func) const;
+    bool walk(Node* node, const Interval<K>& interval, Function&& func) const;
+
+    // Moves every stored (interval, value) into `out` in key order. The tree
+    // is left structurally intact but with moved-from values; callers must
+    // cleanup() or rebuild immediately after.
+    void move_all_sorted(Node* node, std::vector<std::pair<Interval<K>, V>>& out);
+
+    // As move_all_sorted, but only entries for which keep(interval) holds.
+    template <typename Keep>
+    void move_filtered_sorted(Node* node, std::vector<std::pair<Interval<K>, V>>& out,
+                              Keep&& keep);
+
+    // Shared body of remove_overlapping/remove_contained; `matches` selects
+    // the victims among the intervals overlapping `interval`.
+    template <typename Predicate>
+    std::size_t remove_matching(const Interval<K>& interval, Predicate&& matches);
 
     Node* root_ = nullptr;
+    Arena arena_;
+    std::uint64_t generation_ = 0;
+    // Removals since the last full (re)build; cleared by cleanup(), which
+    // every bulk-load path runs through.
+    std::uint64_t churn_ = 0;
 };
 
-template <typename K, typename V>
-void IntervalTree<K, V>::cleanup() {
-    while (root_) {
-        remove(root_);
+template <typename K, typename V, typename Arena>
+void IntervalTree<K, V, Arena>::cleanup() {
+    // Trivially destructible nodes need no per-node teardown, so the whole
+    // traversal is skipped and reset() drops the arena blocks wholesale.
+    if constexpr (!std::is_trivially_destructible_v<Node>) {
+        destroy_subtree(root_);
     }
+    root_ = nullptr;
+    arena_.reset();
+    generation_++;
+    churn_ = 0;
 }
 
-template <typename K, typename V>
-void IntervalTree<K, V>::insert(Interval<K>&& interval, V value) {
-    auto newNode = std::make_unique<IntervalTreeNode<K, V>>();
-    newNode->interval_ = std::move(interval);
-    newNode->max_ = newNode->interval_.high_;
-    newNode->value_ = std::move(value);
-    internal_add(std::move(newNode));
+template <typename K, typename V, typename Arena>
+void IntervalTree<K, V, Arena>::destroy_subtree(Node* node) {
+    if (node) {
+        destroy_subtree(node->left_);
+        destroy_subtree(node->right_);
+        node->~Node();
+    }
 }
 
-template <typename K, typename V>
-void IntervalTree<K, V>::internal_add(NodeType&& newNode) {
+template <typename K, typename V, typename Arena>
+void IntervalTree<K, V, Arena>::insert(Interval<K>&& interval, V value) {
+    auto newNode = arena_.create(std::move(interval), std::move(value));
+    internal_add(newNode);
+}
+
+template <typename K, typename V, typename Arena>
+typename IntervalTree<K, V, Arena>::Node* IntervalTree<K, V, Arena>::insert_hint(
+        Node* hint, Interval<K>&& interval, V value) {
+    auto newNode = arena_.create(std::move(interval), std::move(value));
+    const K key = newNode->key();
+    // The hint is usable when the new key sorts between the hint and its
+    // in-order successor; then the free slot adjacent to the hint (the
+    // hint's right, or the successor's left) is the correct leaf position.
+    if (hint == nullptr || key < hint->key()) {
+        internal_add(newNode);
+        return newNode;
+    }
+    Node* parent;
+    if (hint->right_ == nullptr) {
+        Node* next = successor(hint);
+        if (next && next->key() < key) {
+            internal_add(newNode);
+            return newNode;
+        }
+        parent = hint;
+        hint->right_ = newNode;
+    } else {
+        Node* next = minimum(hint->right_);
+        if (next->key() < key) {
+            internal_add(newNode);
+            return newNode;
+        }
+        parent = next;
+        next->left_ = newNode;
+    }
+    generation_++;
+    newNode->parent_ = parent;
+    for (Node* node = parent; node; node = node->parent_) {
+        node->count_++;
+        if (node->max_ < newNode->interval_.high_) {
+            node->max_ = newNode->interval_.high_;
+        }
+    }
+    // No top-down splitting ran on this path, so the uncle can be red and
+    // the repair may have to climb.
+    if (parent->is_red_) {
+        rb_insert_fixup(newNode);
+    }
+    root_->is_red_ = false;
+    return newNode;
+}
+
+// Bottom-up insert repair for attachments that bypassed internal_add's
+// top-down splitting: recolor past red uncles, then finish with the local
+// rotation fix once the uncle is black.
+template <typename K, typename V, typename Arena>
+void IntervalTree<K, V, Arena>::rb_insert_fixup(Node* node) {
+    while (node->parent_ && node->parent_->is_red_) {
+        Node* parent = node->parent_;
+        Node* grandparent = parent->parent_;
+        Node* uncle = (parent == grandparent->left_) ? grandparent->right_ : grandparent->left_;
+        if (uncle && uncle->is_red_) {
+            parent->is_red_ = false;
+            uncle->is_red_ = false;
+            grandparent->is_red_ = true;
+            node = grandparent;
+        } else {
+            fix_local_violation(node);
+            break;
+        }
+    }
+}
+
+template <typename K, typename V, typename Arena>
+void IntervalTree<K, V, Arena>::build_from_sorted(std::vector<std::pair<Interval<K>, V>>&& items) {
+    cleanup();
+    if (items.empty()) {
+        return;
+    }
+    // Nodes on the deepest level are colored red, everything above is black;
+    // since the mid-split build only leaves holes on the last level, every
+    // path then carries the same number of black nodes.
+    std::size_t bottom = 0;
+    while ((std::size_t{1} << (bottom + 1)) <= items.size()) {
+        bottom++;
+    }
+    root_ = build_range(items, 0, items.size(), 0, bottom);
+    root_->is_red_ = false;
+}
+
+template <typename K, typename V, typename Arena>
+void IntervalTree<K, V, Arena>::insert_batch(std::vector<std::pair<Interval<K>, V>>&& items) {
+    if (items.empty()) {
+        return;
+    }
+    std::sort(items.begin(), items.end(), [](const auto& a, const auto& b) {
+        return a.first.key() < b.first.key();
+    });
+    if (root_ == nullptr) {
+        build_from_sorted(std::move(items));
+        return;
+    }
+    if (items.size() >= size()) {
+        // The batch is at least as large as the tree: merging both sorted
+        // sequences and rebuilding flat costs O(n + m) and yields a
+        // perfectly balanced result, beating m fixup-laden inserts.
+        std::vector<std::pair<Interval<K>, V>> merged;
+        merged.reserve(size() + items.size());
+        move_all_sorted(root_, merged);
+        std::size_t boundary = merged.size();
+        merged.insert(merged.end(), std::make_move_iterator(items.begin()),
+                      std::make_move_iterator(items.end()));
+        std::inplace_merge(merged.begin(), merged.begin() + boundary, merged.end(),
+                           [](const auto& a, const auto& b) { return a.first.key() < b.first.key(); });
+        build_from_sorted(std::move(merged));
+        return;
+    }
+    for (auto& item : items) {
+        insert(std::move(item.first), std::move(item.second));
+    }
+}
+
+template <typename K, typename V, typename Arena>
+typename IntervalTree<K, V, Arena>::Node* IntervalTree<K, V, Arena>::build_range(
+        std::vector<std::pair<Interval<K>, V>>& items, std::size_t first, std::size_t last,
+        std::size_t depth, std::size_t bottom) {
+    if (first == last) {
+        return nullptr;
+    }
+    std::size_t mid = first + (last - first) / 2;
+    auto node = arena_.create(std::move(items[mid].first), std::move(items[mid].second));
+    node->is_red_ = (depth == bottom);
+    node->count_ = last - first;
+    node->left_ = build_range(items, first, mid, depth + 1, bottom);
+    if (node->left_) {
+        node->left_->parent_ = node;
+        node->max_ = std::max(node->max_, node->left_->max_);
+    }
+    node->right_ = build_range(items, mid + 1, last, depth + 1, bottom);
+    if (node->right_) {
+        node->right_->parent_ = node;
+        node->max_ = std::max(node->max_, node->right_->max_);
+    }
+    return node;
+}
+
+template <typename K, typename V, typename Arena>
+bool IntervalTree<K, V, Arena>::isValid() const {
+    if (root_ && (root_->is_red_ || root_->parent_)) {
+        return false;
+    }
+    int black_height = 0;
+    return validate(root_, black_height);
+}
+
+template <typename K, typename V, typename Arena>
+bool IntervalTree<K, V, Arena>::validate(const Node* node, int& black_height) const {
+    if (node == nullptr) {
+        black_height = 1;
+        return true;
+    }
+    if (node->left_ && (node->left_->parent_ != node || node->key() < node->left_->key())) {
+        return false;
+    }
+    if (node->right_ && (node->right_->parent_ != node || node->right_->key() < node->key())) {
+        return false;
+    }
+    if (node->is_red_ && ((node->left_ && node->left_->is_red_) || (node->right_ && node->right_->is_red_))) {
+        return false;
+    }
+    K expected_max = node->interval_.high_;
+    if (node->left_) {
+        expected_max = std::max(expected_max, node->left_->max_);
+    }
+    if (node->right_) {
+        expected_max = std::max(expected_max, node->right_->max_);
+    }
+    if (node->max_ != expected_max) {
+        return false;
+    }
+    std::size_t expected_count = 1 + (node->left_ ? node->left_->count_ : 0) +
+                                 (node->right_ ? node->right_->count_ : 0);
+    if (node->count_ != expected_count) {
+        return false;
+    }
+    int left_height = 0;
+    int right_height = 0;
+    if (!validate(node->left_, left_height) || !validate(node->right_, right_height)) {
+        return false;
+    }
+    if (left_height != right_height) {
+        return false;
+    }
+    black_height = left_height + (node->is_red_ ? 0 : 1);
+    return true;
+}
+
+// Single-pass top-down insertion. Every black node with two red children (a
+// 4-node in 2-3-4 terms) is color-flipped as the descent passes through it,
+// which guarantees that any red-red pair created along the way has a black
+// uncle — so it is repaired immediately by fix_local_violation with one or
+// two rotations, and no fixup loop ever climbs back toward the root after
+// the attach.
+template <typename K, typename V, typename Arena>
+void IntervalTree<K, V, Arena>::internal_add(Node* newNode) {
+    generation_++;
     auto node = root_;
     Node* parent = nullptr;
     while (node) {
+        node->count_++;
+        // Write max_ only when it actually grows; most inserts only change
+        // it on a short suffix of the path.
+        if (node->max_ < newNode->interval_.high_) {
+            node->max_ = newNode->interval_.high_;
+        }
+        if (node->left_ && node->right_ && node->left_->is_red_ && node->right_->is_red_) {
+            node->is_red_ = true;
+            node->left_->is_red_ = false;
+            node->right_->is_red_ = false;
+            if (node->parent_ && node->parent_->is_red_) {
+                // The rotations keep `node` on the search path (it either
+                // stays put or rises to root the repaired subtree), and the
+                // risen node inherits the subtree count_/max_ — including
+                // this insertion's bump — so the descent just carries on.
+                fix_local_violation(node);
+            }
+        }
         parent = node;
-        node->max_ = std::max(node->max_, newNode->interval_.high_);
         if (newNode->key() < node->key()) {
             node = node->left_;
         } else {
@@ -125,120 +668,92 @@ void IntervalTree<K, V>::internal_add(NodeType&& newNode) {
 
     newNode->parent_ = parent;
     if (parent == nullptr) {
-        root_ = newNode.get();
+        root_ = newNode;
     } else if (newNode->key() < parent->key()) {
-        parent->left_ = newNode.get();
+        parent->left_ = newNode;
     } else {
-        parent->right_ = newNode.get();
+        parent->right_ = newNode;
     }
-
-    rb_insert_fixup(newNode.get());
-
-    newNode.release();
+    if (parent && parent->is_red_) {
+        fix_local_violation(newNode);
+    }
+    root_->is_red_ = false;
 }
 
-template <typename K, typename V>
-void IntervalTree<K, V>::rb_insert_fixup(Node* node) {
-    while (node->parent_ && node->parent_->is_red_) {
-        if (node->parent_ == node->parent_->parent_->left_) {
-            auto uncle = node->parent_->parent_->right_;
-            if (uncle && uncle->is_red_) {
-                node->parent_->is_red_ = false;
-                uncle->is_red_ = false;
-                node->parent_->parent_->is_red_ = true;
-                node = node->parent_->parent_;
-            } else {
-                if (node == node->parent_->right_) {
-                    node = node->parent_;
-                    left_rotate(node);
-                }
-                node->parent_->is_red_ = false;
-                if (node->parent_->parent_) {
-                    node->parent_->parent_->is_red_ = true;
-                    right_rotate(node->parent_->parent_);
-                }
-            }
+// Repairs a red `node` whose parent is also red, given that the uncle is
+// black — the invariant internal_add's top-down splitting provides. One
+// (outer grandchild) or two (inner grandchild) rotations and a recolor
+// restore the red-black properties; nothing above the grandparent changes.
+template <typename K, typename V, typename Arena>
+void IntervalTree<K, V, Arena>::fix_local_violation(Node* node) {
+    Node* parent = node->parent_;
+    Node* grandparent = parent->parent_;
+    if (parent == grandparent->left_) {
+        if (node == parent->right_) {
+            left_rotate(parent);
+            right_rotate(grandparent);
+            node->is_red_ = false;
         } else {
-            auto uncle = node->parent_->parent_->left_;
-            if (uncle && uncle->is_red_) {
-                node->parent_->is_red_ = false;
-                uncle->is_red_ = false;
-                node->parent_->parent_->is_red_ = true;
-                node = node->parent_->parent_;
-            } else {
-                if (node == node->parent_->left_) {
-                    node = node->parent_;
-                    right_rotate(node);
-                }
-                node->parent_->is_red_ = false;
-                if (node->parent_->parent_) {
-                    node->parent_->parent_->is_red_ = true;
-                    left_rotate(node->parent_->parent_);
-                }
-            }
+            right_rotate(grandparent);
+            parent->is_red_ = false;
+        }
+    } else {
+        if (node == parent->left_) {
+            right_rotate(parent);
+            left_rotate(grandparent);
+            node->is_red_ = false;
+        } else {
+            left_rotate(grandparent);
+            parent->is_red_ = false;
         }
     }
-    root_->is_red_ = false;
+    grandparent->is_red_ = true;
 }
 
-template <typename K, typename V>
-typename IntervalTree<K, V>::Node* IntervalTree<K, V>::search(const Interval<K>& interval) {
+template <typename K, typename V, typename Arena>
+typename IntervalTree<K, V, Arena>::Node* IntervalTree<K, V, Arena>::search(const Interval<K>& interval) {
     auto node = root_;
     while (node && !node->interval_.overlap(interval)) {
+        ALGO_ITREE_STAT(enter());
         if (node->left_ && node->left_->max_ >= interval.low_) {
             node = node->left_;
         } else {
+            if (node->left_) {
+                ALGO_ITREE_STAT(prunes++);
+            }
             node = node->right_;
         }
     }
+    if (node) {
+        ALGO_ITREE_STAT(enter());
+        ALGO_ITREE_STAT(matches++);
+    }
+    ALGO_ITREE_STAT(depth = 0);
     return node;
 }
 
-template <typename K, typename V>
-void IntervalTree<K, V>::remove(Node* z) {
+template <typename K, typename V, typename Arena>
+void IntervalTree<K, V, Arena>::remove(Node* z) {
     if (!z) {
         return;
     }
+    generation_++;
+    churn_++;
 
-    bool has_two_children = false;
-    if (z->left_ && z->right_) {
-        z->max_ = std::max(z->left_->max_, z->right_->max_);
-    } else if (z->left_) {
-        z->max_ = z->left_->max_;
-    } else if (z->right_) {
-        z->max_ = z->right_->max_;
-    } else {
-        z->max_ = std::numeric_limits<K>::lowest();
-    }
-    Node* successor = nullptr;
-    Node* i = nullptr;
-
-    if (z->left_ && z->right_) {
-        successor = minimum(z->right_);
-        i = successor->parent_;
-        has_two_children = true;
-    } else {
-        i = z->parent_;
-    }
-
-    while (i) {
-        i->max_ = i->interval_.high_;
-        if (i->left_) {
-            i->max_ = std::max(i->max_, i->left_->max_);
+    // Every ancestor of the physically removed position loses one node.
+    {
+        Node* removed = (z->left_ && z->right_) ? minimum(z->right_) : z;
+        for (auto a = removed->parent_; a; a = a->parent_) {
+            a->count_--;
         }
-        if (i->right_) {
-            i->max_ = std::max(i->max_, i->right_->max_);
-        }
-        i = i->parent_;
-    }
-
-    if (has_two_children) {
-        successor->max_ = z->max_;
     }
 
     Node* y = z;
     bool y_original_color = y->is_red_;
     Node* x;
+    // Deepest node whose subtree contents changed; max_ is repaired bottom-up
+    // from here once the unlink is done.
+    Node* max_from = z->parent_;
     if (z->left_ == nullptr) {
         x = z->right_;
         transplant(z, z->right_);
@@ -250,10 +765,12 @@ void IntervalTree<K, V>::remove(Node* z) {
         y_original_color = y->is_red_;
         x = y->right_;
         if (y != z->right_) {
+            max_from = y->parent_;
             transplant(y, y->right_);
             y->right_ = z->right_;
             y->right_->parent_ = y;
         } else {
+            max_from = y;
             if (x) {
                 x->parent_ = y;
             }
@@ -262,77 +779,127 @@ void IntervalTree<K, V>::remove(Node* z) {
         y->left_ = z->left_;
         y->left_->parent_ = y;
         y->is_red_ = z->is_red_;
+        // z's count already reflects the removal (z was on the decremented
+        // path), and y now roots exactly that subtree.
+        y->count_ = z->count_;
+    }
+
+    if (y != z) {
+        // Every node from the successor's old position up to y lost a
+        // descendant, so each needs a recompute; above y the early exit in
+        // update_max_upward applies.
+        for (auto i = max_from; i != y; i = i->parent_) {
+            recompute_max(i);
+        }
+        recompute_max(y);
+        update_max_upward(y->parent_);
+    } else {
+        update_max_upward(max_from);
     }
 
     if (y_original_color == false) {
-        rb_delete_fixup(x);
+        // max_from doubles as x's parent: in every branch above it ends up
+        // holding the node x now hangs off of.
+        rb_delete_fixup(x, max_from);
     }
 
-    std::unique_ptr<Node> old_node(z);
+    arena_.destroy(z);
 }
 
-template <typename K, typename V>
-void IntervalTree<K, V>::rb_delete_fixup(Node* x) {
-    while (x && x != root_ && !x->is_red_) {
-        if (x == x->parent_->left_) {
-            Node* w = x->parent_->right_;
-            if (!w) {
-                x = x->parent_;
-                continue;
-            }
+template <typename K, typename V, typename Arena>
+void IntervalTree<K, V, Arena>::compact() {
+    std::vector<std::pair<Interval<K>, V>> items;
+    items.reserve(size());
+    move_all_sorted(root_, items);
+    // build_from_sorted runs through cleanup(), so the arena is reset and
+    // the rebuilt nodes come out of one sequential allocation sweep.
+    build_from_sorted(std::move(items));
+}
+
+template <typename K, typename V, typename Arena>
+bool IntervalTree<K, V, Arena>::maybe_compact() {
+    // One removal per live node since the last rebuild means roughly every
+    // arena slot has been recycled once — the point where placement no
+    // longer resembles tree order. Tiny trees fit in cache regardless, so
+    // don't bother below a floor.
+    if (churn_ < 64 || churn_ < size()) {
+        return false;
+    }
+    compact();
+    return true;
+}
+
+template <typename K, typename V, typename Arena>
+void IntervalTree<K, V, Arena>::update_max_upward(Node* node) {
+    while (node) {
+        K old_max = node->max_;
+        recompute_max(node);
+        if (node->max_ == old_max) {
+            // This ancestor's max_ was not defined by the removed interval,
+            // so nothing above it can change either.
+            break;
+        }
+        node = node->parent_;
+    }
+}
+
+template <typename K, typename V, typename Arena>
+void IntervalTree<K, V, Arena>::rb_delete_fixup(Node* x, Node* parent) {
+    // x is the node standing in for the removed black node and may be null,
+    // so its parent is tracked explicitly instead of read through x. While x
+    // carries the extra black, its sibling w is never null in a valid tree.
+    while (x != root_ && (x == nullptr || !x->is_red_)) {
+        if (x == parent->left_) {
+            Node* w = parent->right_;
             if (w->is_red_) {
                 w->is_red_ = false;
-                x->parent_->is_red_ = true;
-                left_rotate(x->parent_);
-                w = x->parent_->right_;
+                parent->is_red_ = true;
+                left_rotate(parent);
+                w = parent->right_;
             }
-            if (!w || ((!w->left_ || !w->left_->is_red_) && (!w->right_ || !w->right_->is_red_))) {
-                if (w) {
-                    w->is_red_ = true;
-                }
-                x = x->parent_;
+            if ((!w->left_ || !w->left_->is_red_) && (!w->right_ || !w->right_->is_red_)) {
+                w->is_red_ = true;
+                x = parent;
+                parent = x->parent_;
             } else {
                 if (!w->right_ || !w->right_->is_red_) {
                     w->left_->is_red_ = false;
                     w->is_red_ = true;
                     right_rotate(w);
-                    w = x->parent_->right_;
+                    w = parent->right_;
                 }
-                w->is_red_ = x->parent_->is_red_;
-                x->parent_->is_red_ = false;
+                w->is_red_ = parent->is_red_;
+                parent->is_red_ = false;
                 w->right_->is_red_ = false;
-                left_rotate(x->parent_);
+                left_rotate(parent);
                 x = root_;
+                parent = nullptr;
             }
         } else {
-            Node* w = x->parent_->left_;
-            if (!w) {
-                x = x->parent_;
-                continue;
-            }
+            Node* w = parent->left_;
             if (w->is_red_) {
                 w->is_red_ = false;
-                x->parent_->is_red_ = true;
-                right_rotate(x->parent_);
-                w = x->parent_->left_;
+                parent->is_red_ = true;
+                right_rotate(parent);
+                w = parent->left_;
             }
-            if (!w || ((!w->right_ || !w->right_->is_red_) && (!w->left_ || !w->left_->is_red_))) {
-                if (w) {
-                    w->is_red_ = true;
-                }
-                x = x->parent_;
+            if ((!w->right_ || !w->right_->is_red_) && (!w->left_ || !w->left_->is_red_)) {
+                w->is_red_ = true;
+                x = parent;
+                parent = x->parent_;
             } else {
                 if (!w->left_ || !w->left_->is_red_) {
                     w->right_->is_red_ = false;
                     w->is_red_ = true;
                     left_rotate(w);
-                    w = x->parent_->left_;
+                    w = parent->left_;
                 }
-                w->is_red_ = x->parent_->is_red_;
-                x->parent_->is_red_ = false;
+                w->is_red_ = parent->is_red_;
+                parent->is_red_ = false;
                 w->left_->is_red_ = false;
-                right_rotate(x->parent_);
+                right_rotate(parent);
                 x = root_;
+                parent = nullptr;
             }
         }
     }
@@ -341,16 +908,29 @@ void IntervalTree<K, V>::rb_delete_fixup(Node* x) {
     }
 }
 
-template <typename K, typename V>
-typename IntervalTree<K, V>::Node* IntervalTree<K, V>::minimum(Node* node) {
+template <typename K, typename V, typename Arena>
+typename IntervalTree<K, V, Arena>::Node* IntervalTree<K, V, Arena>::minimum(Node* node) {
     while (node->left_) {
         node = node->left_;
     }
     return node;
 }
 
-template <typename K, typename V>
-void IntervalTree<K, V>::transplant(Node* u, Node* v) {
+template <typename K, typename V, typename Arena>
+typename IntervalTree<K, V, Arena>::Node* IntervalTree<K, V, Arena>::successor(Node* node) {
+    if (node->right_) {
+        return minimum(node->right_);
+    }
+    Node* parent = node->parent_;
+    while (parent && node == parent->right_) {
+        node = parent;
+        parent = parent->parent_;
+    }
+    return parent;
+}
+
+template <typename K, typename V, typename Arena>
+void IntervalTree<K, V, Arena>::transplant(Node* u, Node* v) {
     if (u->parent_ == nullptr) {
         root_ = v;
     } else if (u == u->parent_->left_) {
@@ -363,8 +943,8 @@ void IntervalTree<K, V>::transplant(Node* u, Node* v) {
     }
 }
 
-template <typename K, typename V>
-void IntervalTree<K, V>::left_rotate(Node* x) {
+template <typename K, typename V, typename Arena>
+void IntervalTree<K, V, Arena>::left_rotate(Node* x) {
     Node* y = x->right_;
     x->right_ = y->left_;
     if (y->left_) {
@@ -381,18 +961,19 @@ void IntervalTree<K, V>::left_rotate(Node* x) {
     y->left_ = x;
     x->parent_ = y;
 
+    // y inherits x's max_ and count_ unchanged (it now roots the same
+    // subtree); only x needs a recompute, and max_ only when a child no
+    // longer supplies it.
+    y->count_ = x->count_;
+    x->count_ = 1 + (x->left_ ? x->left_->count_ : 0) + (x->right_ ? x->right_->count_ : 0);
     y->max_ = x->max_;
-    x->max_ = x->interval_.high_;
-    if (x->left_ && x->left_->max_ > x->max_) {
-        x->max_ = x->left_->max_;
-    }
-    if (x->right_ && x->right_->max_ > x->max_) {
-        x->max_ = x->right_->max_;
+    if (x->max_ != x->interval_.high_) {
+        recompute_max(x);
     }
 }
 
-template <typename K, typename V>
-void IntervalTree<K, V>::right_rotate(Node* x) {
+template <typename K, typename V, typename Arena>
+void IntervalTree<K, V, Arena>::right_rotate(Node* x) {
     Node* y = x->left_;
     x->left_ = y->right_;
     if (y->right_) {
@@ -409,7 +990,19 @@ void IntervalTree<K, V>::right_rotate(Node* x) {
     y->right_ = x;
     x->parent_ = y;
 
+    // y inherits x's max_ and count_ unchanged (it now roots the same
+    // subtree); only x needs a recompute, and max_ only when a child no
+    // longer supplies it.
+    y->count_ = x->count_;
+    x->count_ = 1 + (x->left_ ? x->left_->count_ : 0) + (x->right_ ? x->right_->count_ : 0);
     y->max_ = x->max_;
+    if (x->max_ != x->interval_.high_) {
+        recompute_max(x);
+    }
+}
+
+template <typename K, typename V, typename Arena>
+void IntervalTree<K, V, Arena>::recompute_max(Node* x) {
     x->max_ = x->interval_.high_;
     if (x->left_ && x->left_->max_ > x->max_) {
         x->max_ = x->left_->max_;
@@ -419,15 +1012,15 @@ void IntervalTree<K, V>::right_rotate(Node* x) {
     }
 }
 
-template <typename K, typename V>
+template <typename K, typename V, typename Arena>
 template <typename Function>
-void IntervalTree<K, V>::inorder(Function&& func) const {
+void IntervalTree<K, V, Arena>::inorder(Function&& func) const {
     inorder(root_, std::forward<Function>(func));
 }
 
-template <typename K, typename V>
+template <typename K, typename V, typename Arena>
 template <typename Function>
-void IntervalTree<K, V>::inorder(Node* node, Function&& func) const {
+void IntervalTree<K, V, Arena>::inorder(Node* node, Function&& func) const {
     if (node) {
         inorder(node->left_, std::forward<Function>(func));
         func(node->interval_, node->value_);
@@ -435,8 +1028,77 @@ void IntervalTree<K, V>::inorder(Node* node, Function&& func) const {
     }
 }
 
-template <typename K, typename V>
-std::string IntervalTree<K, V>::print() const {
+template <typename K, typename V, typename Arena>
+void IntervalTree<K, V, Arena>::move_all_sorted(Node* node,
+                                                std::vector<std::pair<Interval<K>, V>>& out) {
+    if (node) {
+        move_all_sorted(node->left_, out);
+        out.emplace_back(std::move(node->interval_), std::move(node->value_));
+        move_all_sorted(node->right_, out);
+    }
+}
+
+template <typename K, typename V, typename Arena>
+template <typename Keep>
+void IntervalTree<K, V, Arena>::move_filtered_sorted(Node* node,
+                                                     std::vector<std::pair<Interval<K>, V>>& out,
+                                                     Keep&& keep) {
+    if (node) {
+        move_filtered_sorted(node->left_, out, std::forward<Keep>(keep));
+        if (keep(node->interval_)) {
+            out.emplace_back(std::move(node->interval_), std::move(node->value_));
+        }
+        move_filtered_sorted(node->right_, out, std::forward<Keep>(keep));
+    }
+}
+
+template <typename K, typename V, typename Arena>
+template <typename Predicate>
+std::size_t IntervalTree<K, V, Arena>::remove_matching(const Interval<K>& interval,
+                                                       Predicate&& matches) {
+    std::vector<Node*> victims;
+    collect_overlapping(interval, victims);
+    victims.erase(std::remove_if(victims.begin(), victims.end(),
+                                 [&](Node* node) { return !matches(node->interval_); }),
+                  victims.end());
+    if (victims.empty()) {
+        return 0;
+    }
+    // Unlinking k nodes costs k fixups and k ancestor max_ repairs; past a
+    // quarter of the tree, one flat rebuild of the survivors is cheaper and
+    // leaves a perfectly balanced result.
+    if (victims.size() * 4 > size()) {
+        std::vector<std::pair<Interval<K>, V>> survivors;
+        survivors.reserve(size() - victims.size());
+        move_filtered_sorted(root_, survivors, [&](const Interval<K>& stored) {
+            return !(stored.overlap(interval) && matches(stored));
+        });
+        std::size_t removed = size() - survivors.size();
+        build_from_sorted(std::move(survivors));
+        return removed;
+    }
+    // Successor swaps in remove() reuse victim nodes in place, so the
+    // collected pointers stay valid throughout.
+    for (auto node : victims) {
+        remove(node);
+    }
+    return victims.size();
+}
+
+template <typename K, typename V, typename Arena>
+std::size_t IntervalTree<K, V, Arena>::remove_overlapping(const Interval<K>& interval) {
+    return remove_matching(interval, [](const Interval<K>&) { return true; });
+}
+
+template <typename K, typename V, typename Arena>
+std::size_t IntervalTree<K, V, Arena>::remove_contained(const Interval<K>& interval) {
+    return remove_matching(interval, [&](const Interval<K>& stored) {
+        return interval.low_ <= stored.low_ && stored.high_ <= interval.high_;
+    });
+}
+
+template <typename K, typename V, typename Arena>
+std::string IntervalTree<K, V, Arena>::print() const {
     std::string res;
     inorder([&](const auto& interval, const auto& value) {
         res += std::to_string(interval.low_) + " " + std::to_string(interval.high_) + "\n";
@@ -445,27 +1107,270 @@ std::string IntervalTree<K, V>::print() const {
 }
 
 
-template <typename K, typename V>
+template <typename K, typename V, typename Arena>
 template <typename Function>
-void IntervalTree<K, V>::walk(const Interval<K>& interval, Function&& func) const {
+void IntervalTree<K, V, Arena>::walk(const Interval<K>& interval, Function&& func) const {
     walk(root_, interval, std::forward<Function>(func));
 }
 
 
-template <typename K, typename V>
+template <typename K, typename V, typename Arena>
 template <typename Function>
-void IntervalTree<K, V>::walk(Node* node, const Interval<K>& interval, Function&& func) const {
+bool IntervalTree<K, V, Arena>::walk(Node* node, const Interval<K>& interval, Function&& func) const {
     if (node == nullptr) {
-        return;
+        return true;
     }
-    if (node->left_ && interval.low_ < node->left_->max_) {
-        walk(node->left_, interval, std::forward<Function>(func));
+    ALGO_ITREE_STAT_SCOPE();
+    if (node->left_ && interval.low_ <= node->left_->max_) {
+        if (!walk(node->left_, interval, std::forward<Function>(func))) {
+            return false;
+        }
+    } else if (node->left_) {
+        ALGO_ITREE_STAT(prunes++);
     }
     if (node->interval_.overlap(interval)) {
-        func(node->interval_, node->value_);
+        ALGO_ITREE_STAT(matches++);
+        if (!visit(func, node->interval_, node->value_)) {
+            return false;
+        }
+    }
+    if (node->right_ && node->key() <= interval.high_ && interval.low_ <= node->right_->max_) {
+        return walk(node->right_, interval, std::forward<Function>(func));
+    }
+    if (node->right_) {
+        ALGO_ITREE_STAT(prunes++);
+    }
+    return true;
+}
+
+template <typename K, typename V, typename Arena>
+template <typename Function>
+void IntervalTree<K, V, Arena>::query(const Interval<K>& interval, QueryContext& ctx, Function&& func) const {
+    ctx.clear();
+    auto node = root_;
+    for (;;) {
+        while (node) {
+            ctx.push(node);
+            node = (node->left_ && interval.low_ <= node->left_->max_) ? node->left_ : nullptr;
+        }
+        if (ctx.empty()) {
+            break;
+        }
+        node = ctx.pop();
+        if (node->interval_.overlap(interval)) {
+            if (!visit(func, node->interval_, node->value_)) {
+                return;
+            }
+        }
+        node = (node->right_ && node->key() <= interval.high_ && interval.low_ <= node->right_->max_) ? node->right_ : nullptr;
+    }
+}
+
+template <typename K, typename V, typename Arena>
+bool IntervalTree<K, V, Arena>::overlaps(const Interval<K>& interval) const {
+    auto node = root_;
+    while (node && !node->interval_.overlap(interval)) {
+        if (node->left_ && node->left_->max_ >= interval.low_) {
+            node = node->left_;
+        } else {
+            node = node->right_;
+        }
+    }
+    return node != nullptr;
+}
+
+template <typename K, typename V, typename Arena>
+std::size_t IntervalTree<K, V, Arena>::count_overlaps(const Interval<K>& interval) const {
+    // Overlap is low_ <= interval.high_ && high_ >= interval.low_, and every
+    // interval with high_ < interval.low_ also has low_ <= interval.high_,
+    // so the two counts below subtract cleanly.
+    std::size_t low_leq = 0;
+    auto node = root_;
+    while (node) {
+        if (node->key() <= interval.high_) {
+            low_leq += 1 + (node->left_ ? node->left_->count_ : 0);
+            node = node->right_;
+        } else {
+            node = node->left_;
+        }
+    }
+    return low_leq - count_high_below(root_, interval.low_, interval.high_);
+}
+
+template <typename K, typename V, typename Arena>
+std::size_t IntervalTree<K, V, Arena>::count_high_below(const Node* node, const K& bound,
+                                                        const K& cap) const {
+    if (node == nullptr) {
+        return 0;
+    }
+    if (node->max_ < bound) {
+        // Every high_ in this subtree is below the bound.
+        return node->count_;
+    }
+    if (node->key() > cap) {
+        // low_ > cap >= bound forces high_ >= bound for this node and its
+        // whole right subtree: neither can contribute, descend left only.
+        return count_high_below(node->left_, bound, cap);
+    }
+    return (node->interval_.high_ < bound ? 1 : 0) + count_high_below(node->left_, bound, cap) +
+           count_high_below(node->right_, bound, cap);
+}
+
+template <typename K, typename V, typename Arena>
+typename IntervalTree<K, V, Arena>::Node* IntervalTree<K, V, Arena>::kth(std::size_t k) {
+    auto node = root_;
+    while (node) {
+        std::size_t left_count = node->left_ ? node->left_->count_ : 0;
+        if (k < left_count) {
+            node = node->left_;
+        } else if (k == left_count) {
+            return node;
+        } else {
+            k -= left_count + 1;
+            node = node->right_;
+        }
+    }
+    return nullptr;
+}
+
+template <typename K, typename V, typename Arena>
+typename IntervalTree<K, V, Arena>::Node* IntervalTree<K, V, Arena>::lower_bound(const K& key) {
+    Node* result = nullptr;
+    auto node = root_;
+    while (node) {
+        if (!(node->key() < key)) {
+            result = node;
+            node = node->left_;
+        } else {
+            node = node->right_;
+        }
+    }
+    return result;
+}
+
+template <typename K, typename V, typename Arena>
+typename IntervalTree<K, V, Arena>::Node* IntervalTree<K, V, Arena>::next_after(const K& key) {
+    Node* result = nullptr;
+    auto node = root_;
+    while (node) {
+        if (key < node->key()) {
+            result = node;
+            node = node->left_;
+        } else {
+            node = node->right_;
+        }
+    }
+    return result;
+}
+
+template <typename K, typename V, typename Arena>
+typename IntervalTree<K, V, Arena>::Node* IntervalTree<K, V, Arena>::prev_before(const K& key) {
+    Node* result = nullptr;
+    auto node = root_;
+    while (node) {
+        if (node->key() < key) {
+            result = node;
+            node = node->right_;
+        } else {
+            node = node->left_;
+        }
+    }
+    return result;
+}
+
+template <typename K, typename V, typename Arena>
+K IntervalTree<K, V, Arena>::find_gap(const K& from, const K& width) {
+    K gap = from;
+    for (;;) {
+        assert(gap <= std::numeric_limits<K>::max() - width &&
+               "find_gap window extends past the key type's maximum");
+        auto blocker = search({gap, gap + width});
+        if (blocker == nullptr) {
+            return gap;
+        }
+        assert(blocker->interval_.high_ < std::numeric_limits<K>::max() &&
+               "no representable start past a blocker ending at the key type's maximum");
+        gap = blocker->interval_.high_ + K{1};
     }
-    if (node->right_ && interval.low_ < node->right_->max_) {
-        walk(node->right_, interval, std::forward<Function>(func));
+}
+
+template <typename K, typename V, typename Arena>
+std::size_t IntervalTree<K, V, Arena>::rank(const K& key) const {
+    std::size_t result = 0;
+    auto node = root_;
+    while (node) {
+        if (node->key() < key) {
+            result += 1 + (node->left_ ? node->left_->count_ : 0);
+            node = node->right_;
+        } else {
+            node = node->left_;
+        }
+    }
+    return result;
+}
+
+template <typename K, typename V, typename Arena>
+std::size_t IntervalTree<K, V, Arena>::rank_leq(const K& key) const {
+    std::size_t result = 0;
+    auto node = root_;
+    while (node) {
+        if (!(key < node->key())) {
+            result += 1 + (node->left_ ? node->left_->count_ : 0);
+            node = node->right_;
+        } else {
+            node = node->left_;
+        }
+    }
+    return result;
+}
+
+template <typename K, typename V, typename Arena>
+void IntervalTree<K, V, Arena>::collect_overlapping(const Interval<K>& interval, std::vector<Node*>& out) {
+    QueryContext ctx;
+    auto node = root_;
+    for (;;) {
+        while (node) {
+            ctx.push(node);
+            node = (node->left_ && interval.low_ <= node->left_->max_) ? node->left_ : nullptr;
+        }
+        if (ctx.empty()) {
+            break;
+        }
+        node = ctx.pop();
+        if (node->interval_.overlap(interval)) {
+            out.push_back(node);
+        }
+        node = (node->right_ && node->key() <= interval.high_ && interval.low_ <= node->right_->max_) ? node->right_ : nullptr;
+    }
+}
+
+template <typename K, typename V, typename Arena>
+template <typename Merge>
+void IntervalTree<K, V, Arena>::insert_merging(Interval<K>&& interval, V value, Merge&& merge) {
+    std::vector<Node*> overlapping;
+    collect_overlapping(interval, overlapping);
+    for (auto node : overlapping) {
+        interval.low_ = std::min(interval.low_, node->interval_.low_);
+        interval.high_ = std::max(interval.high_, node->interval_.high_);
+        merge(value, std::move(node->value_));
+        remove(node);
+    }
+    insert(std::move(interval), std::move(value));
+}
+
+template <typename K, typename V, typename Arena>
+template <typename Function>
+void IntervalTree<K, V, Arena>::walk_batch(const std::vector<Interval<K>>& queries, Function&& func) const {
+    std::vector<std::size_t> order(queries.size());
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return queries[a].low_ < queries[b].low_;
+    });
+    QueryContext ctx;
+    for (auto qi : order) {
+        query(queries[qi], ctx, [&](const Interval<K>& interval, const V& value) {
+            func(qi, interval, value);
+        });
     }
 }
 
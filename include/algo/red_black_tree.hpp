@@ -0,0 +1,278 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <functional>
+
+#include "binary_search_tree.hpp"
+
+namespace algo {
+
+// Self-balancing BinarySearchTree. The plain tree degrades to a linked list
+// under monotonic key ingestion, taking at()/contains() to O(n); this
+// variant plugs a colored node into the Node template parameter and runs
+// red-black insert/delete fixups, bounding the height at 2*log2(n+1) so
+// lookups stay O(log n) for any insertion order. add() and remove() hide
+// the base versions — use this class by value, not through the base.
+template <typename T, typename U, typename Compare = std::less<T>>
+class RedBlackTree : public BinarySearchTree<T, U, Compare, internal::RedBlackTreeNode<T, U>> {
+public:
+    using Node = internal::RedBlackTreeNode<T, U>;
+    using Base = BinarySearchTree<T, U, Compare, Node>;
+
+    void add(const T& key, U value) {
+        auto node = std::make_unique<Node>(T{key}, std::move(value));
+        Node* raw = node.get();
+        this->internal_add(std::move(node));
+        rb_insert_fixup(raw);
+    }
+
+    void remove(const T& key);
+
+    // The base node-handle paths skip the delete/insert fixups and would
+    // silently break the color and black-height invariants, so they are
+    // not merely hidden here (as add/remove are) but deleted outright.
+    typename Base::NodeHandle extract(Node* node) = delete;
+    void insert(typename Base::NodeHandle&& node) = delete;
+    void remove(Node* node) = delete;
+
+    // Checks the red-black invariants on top of the base BST check: red
+    // nodes have black children and every root-to-null path carries the
+    // same number of black nodes.
+    bool isValid() const {
+        if (!this->isBST()) {
+            return false;
+        }
+        if (this->root_ && this->root_->isRed()) {
+            return false;
+        }
+        int black_height = 0;
+        return validate(this->root_, black_height);
+    }
+
+    int height() const { return height(this->root_); }
+
+private:
+    void rb_insert_fixup(Node* node);
+    void rb_delete_fixup(Node* x, Node* parent);
+
+    void left_rotate(Node* x);
+    void right_rotate(Node* x);
+
+    static bool is_black(const Node* node) { return node == nullptr || !node->isRed(); }
+
+    static bool validate(const Node* node, int& black_height) {
+        if (node == nullptr) {
+            black_height = 1;
+            return true;
+        }
+        if (node->isRed() && (!is_black(node->left()) || !is_black(node->right()))) {
+            return false;
+        }
+        int left_height = 0;
+        int right_height = 0;
+        if (!validate(node->left(), left_height) || !validate(node->right(), right_height)) {
+            return false;
+        }
+        if (left_height != right_height) {
+            return false;
+        }
+        black_height = left_height + (node->isRed() ? 0 : 1);
+        return true;
+    }
+
+    static int height(const Node* node) {
+        if (node == nullptr) {
+            return 0;
+        }
+        return 1 + std::max(height(node->left()), height(node->right()));
+    }
+};
+
+template <typename T, typename U, typename Compare>
+void RedBlackTree<T, U, Compare>::rb_insert_fixup(Node* node) {
+    while (node->parent() && node->parent()->isRed()) {
+        Node* parent = node->parent();
+        Node* grandparent = parent->parent();
+        if (parent == grandparent->left()) {
+            Node* uncle = grandparent->right();
+            if (uncle && uncle->isRed()) {
+                parent->setRed(false);
+                uncle->setRed(false);
+                grandparent->setRed(true);
+                node = grandparent;
+            } else {
+                if (node == parent->right()) {
+                    node = parent;
+                    left_rotate(node);
+                }
+                node->parent()->setRed(false);
+                grandparent = node->parent()->parent();
+                grandparent->setRed(true);
+                right_rotate(grandparent);
+            }
+        } else {
+            Node* uncle = grandparent->left();
+            if (uncle && uncle->isRed()) {
+                parent->setRed(false);
+                uncle->setRed(false);
+                grandparent->setRed(true);
+                node = grandparent;
+            } else {
+                if (node == parent->left()) {
+                    node = parent;
+                    right_rotate(node);
+                }
+                node->parent()->setRed(false);
+                grandparent = node->parent()->parent();
+                grandparent->setRed(true);
+                left_rotate(grandparent);
+            }
+        }
+    }
+    this->root_->setRed(false);
+}
+
+template <typename T, typename U, typename Compare>
+void RedBlackTree<T, U, Compare>::remove(const T& key) {
+    Node* z = this->search(key);
+    if (z == nullptr) {
+        return;
+    }
+
+    // CLRS delete: y is the node physically unlinked, x the child taking its
+    // place, and `parent` x's parent afterwards — tracked explicitly because
+    // x may be null.
+    Node* y = z;
+    bool y_was_black = !y->isRed();
+    Node* x = nullptr;
+    Node* parent = nullptr;
+    if (z->left() == nullptr) {
+        x = z->right();
+        parent = z->parent();
+        this->transplant(z, z->takeRight());
+    } else if (z->right() == nullptr) {
+        x = z->left();
+        parent = z->parent();
+        this->transplant(z, z->takeLeft());
+    } else {
+        y = this->minimum(z->right());
+        y_was_black = !y->isRed();
+        x = y->right();
+        if (y != z->right()) {
+            parent = y->parent();
+            this->transplant(y, y->takeRight());
+            y->setRight(z->takeRight());
+        } else {
+            parent = y;
+        }
+        this->transplant(z, y);
+        y->setLeft(z->takeLeft());
+        y->setRed(z->isRed());
+    }
+
+    this->sz_--;
+    std::unique_ptr<Node> old_node(z);
+    if (y_was_black) {
+        rb_delete_fixup(x, parent);
+    }
+    if (this->root_) {
+        this->root_->setRed(false);
+    }
+}
+
+template <typename T, typename U, typename Compare>
+void RedBlackTree<T, U, Compare>::rb_delete_fixup(Node* x, Node* parent) {
+    while (x != this->root_ && is_black(x)) {
+        if (x == parent->left()) {
+            Node* sibling = parent->right();
+            if (sibling->isRed()) {
+                sibling->setRed(false);
+                parent->setRed(true);
+                left_rotate(parent);
+                sibling = parent->right();
+            }
+            if (is_black(sibling->left()) && is_black(sibling->right())) {
+                sibling->setRed(true);
+                x = parent;
+                parent = x->parent();
+            } else {
+                if (is_black(sibling->right())) {
+                    sibling->left()->setRed(false);
+                    sibling->setRed(true);
+                    right_rotate(sibling);
+                    sibling = parent->right();
+                }
+                sibling->setRed(parent->isRed());
+                parent->setRed(false);
+                sibling->right()->setRed(false);
+                left_rotate(parent);
+                x = this->root_;
+            }
+        } else {
+            Node* sibling = parent->left();
+            if (sibling->isRed()) {
+                sibling->setRed(false);
+                parent->setRed(true);
+                right_rotate(parent);
+                sibling = parent->left();
+            }
+            if (is_black(sibling->left()) && is_black(sibling->right())) {
+                sibling->setRed(true);
+                x = parent;
+                parent = x->parent();
+            } else {
+                if (is_black(sibling->left())) {
+                    sibling->right()->setRed(false);
+                    sibling->setRed(true);
+                    left_rotate(sibling);
+                    sibling = parent->left();
+                }
+                sibling->setRed(parent->isRed());
+                parent->setRed(false);
+                sibling->left()->setRed(false);
+                right_rotate(parent);
+                x = this->root_;
+            }
+        }
+    }
+    if (x) {
+        x->setRed(false);
+    }
+}
+
+template <typename T, typename U, typename Compare>
+void RedBlackTree<T, U, Compare>::left_rotate(Node* x) {
+    Node* parent = x->parent();
+    bool x_was_left = parent && x == parent->left();
+    Node* y = x->takeRight();
+    x->setRight(y->takeLeft());
+    if (parent == nullptr) {
+        this->root_ = y;
+        y->setParent(nullptr);
+    } else if (x_was_left) {
+        parent->setLeft(y);
+    } else {
+        parent->setRight(y);
+    }
+    y->setLeft(x);
+}
+
+template <typename T, typename U, typename Compare>
+void RedBlackTree<T, U, Compare>::right_rotate(Node* x) {
+    Node* parent = x->parent();
+    bool x_was_left = parent && x == parent->left();
+    Node* y = x->takeLeft();
+    x->setLeft(y->takeRight());
+    if (parent == nullptr) {
+        this->root_ = y;
+        y->setParent(nullptr);
+    } else if (x_was_left) {
+        parent->setLeft(y);
+    } else {
+        parent->setRight(y);
+    }
+    y->setRight(x);
+}
+
+}  // namespace algo
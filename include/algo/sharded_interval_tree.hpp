@@ -0,0 +1,124 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "interval_tree.hpp"
+
+namespace algo {
+
+// Multi-writer wrapper around IntervalTree. Where ConcurrentIntervalTree
+// serializes all writers on one mutex, this partitions the key space across
+// S independent trees — each with its own lock and arena — so writers
+// touching different key ranges never contend and insert throughput scales
+// with the shard count. Intervals are routed by their low endpoint against
+// boundaries learned from a sample of the data (quantiles, so shards stay
+// balanced even for skewed keys).
+//
+// Queries lock shards one at a time: every shard up to the one owning
+// q.high_ is visited, since an interval routed left of the query can still
+// reach into it — the per-shard max_ pruning makes those walks cheap when
+// nothing does. Shards right of q.high_ only hold intervals starting past
+// the query and are skipped. Visiting shards in order keeps the stitched
+// walk sorted by low endpoint, same as IntervalTree::walk.
+template <typename K, typename V>
+class ShardedIntervalTree {
+public:
+    // `sample` is a representative set of low endpoints (it does not need
+    // to be sorted or complete); the S-1 boundaries are its quantiles. An
+    // empty sample collapses to a single shard.
+    ShardedIntervalTree(std::vector<K> sample, std::size_t shard_count) {
+        assert(shard_count > 0 && "ShardedIntervalTree needs at least one shard");
+        std::sort(sample.begin(), sample.end());
+        if (!sample.empty()) {
+            for (std::size_t i = 1; i < shard_count; i++) {
+                boundaries_.push_back(sample[i * sample.size() / shard_count]);
+            }
+            boundaries_.erase(std::unique(boundaries_.begin(), boundaries_.end()),
+                              boundaries_.end());
+        }
+        shards_.reserve(boundaries_.size() + 1);
+        for (std::size_t i = 0; i <= boundaries_.size(); i++) {
+            shards_.push_back(std::make_unique<Shard>());
+        }
+    }
+
+    ShardedIntervalTree(const ShardedIntervalTree&) = delete;
+    ShardedIntervalTree& operator=(const ShardedIntervalTree&) = delete;
+
+    std::size_t shard_count() const { return shards_.size(); }
+
+    std::size_t size() const { return size_.load(std::memory_order_relaxed); }
+
+    void insert(Interval<K>&& interval, V value) {
+        Shard& shard = *shards_[shard_of(interval.low_)];
+        std::lock_guard<std::mutex> guard(shard.mutex);
+        shard.tree.insert(std::move(interval), std::move(value));
+        size_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // In-order visit of every stored interval overlapping `interval`.
+    // Shards are locked one at a time, so the result is not a snapshot of
+    // a single instant when writers are active — each shard's contribution
+    // is individually consistent.
+    template <typename Function>
+    void walk(const Interval<K>& interval, Function&& func) const {
+        std::size_t last = shard_of(interval.high_);
+        for (std::size_t i = 0; i <= last; i++) {
+            Shard& shard = *shards_[i];
+            std::lock_guard<std::mutex> guard(shard.mutex);
+            shard.tree.walk(interval, func);
+        }
+    }
+
+    bool overlaps(const Interval<K>& interval) const {
+        std::size_t last = shard_of(interval.high_);
+        for (std::size_t i = 0; i <= last; i++) {
+            Shard& shard = *shards_[i];
+            std::lock_guard<std::mutex> guard(shard.mutex);
+            if (shard.tree.overlaps(interval)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Removes every stored interval overlapping `interval` across all
+    // affected shards; returns how many were removed.
+    std::size_t remove_overlapping(const Interval<K>& interval) {
+        std::size_t removed = 0;
+        std::size_t last = shard_of(interval.high_);
+        for (std::size_t i = 0; i <= last; i++) {
+            Shard& shard = *shards_[i];
+            std::lock_guard<std::mutex> guard(shard.mutex);
+            removed += shard.tree.remove_overlapping(interval);
+        }
+        size_.fetch_sub(removed, std::memory_order_relaxed);
+        return removed;
+    }
+
+private:
+    // Shards get their own cache lines so one writer's lock traffic does
+    // not bounce the line under its neighbours; unique_ptr keeps them
+    // stable (std::mutex is not movable).
+    struct alignas(64) Shard {
+        mutable std::mutex mutex;
+        IntervalTree<K, V> tree;
+    };
+
+    // Shard i owns lows in [boundaries_[i-1], boundaries_[i]).
+    std::size_t shard_of(const K& low) const {
+        return static_cast<std::size_t>(
+            std::upper_bound(boundaries_.begin(), boundaries_.end(), low) - boundaries_.begin());
+    }
+
+    std::vector<K> boundaries_;
+    std::vector<std::unique_ptr<Shard>> shards_;
+    std::atomic<std::size_t> size_{0};
+};
+
+}  // namespace algo
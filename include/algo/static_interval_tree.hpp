@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+#include "interval_tree.hpp"
+
+namespace algo {
+
+// Compile-time interval tree for rule tables fixed at build time. The N
+// intervals are insertion-sorted by low_ in the constexpr constructor and
+// queried through the implicit mid-split structure (the "node" of a range
+// is its middle element, exactly as build_from_sorted lays trees out), with
+// a subtree-max array for the usual pruning. Everything lives in
+// std::arrays inside the object — no allocation, no pointers, no startup
+// construction — and with a constexpr table the optimizer can inline the
+// whole descent and constant-fold the max_ tests against the known rule
+// set. K and V must be literal types with constexpr copy/assign (the usual
+// ints and enums are).
+template <typename K, typename V, std::size_t N>
+class StaticIntervalTree {
+public:
+    explicit constexpr StaticIntervalTree(const std::array<std::pair<Interval<K>, V>, N>& items) {
+        for (std::size_t i = 0; i < N; i++) {
+            intervals_[i] = items[i].first;
+            values_[i] = items[i].second;
+        }
+        // Insertion sort in lockstep: std::sort is not constexpr in C++17,
+        // and N is rule-table sized.
+        for (std::size_t i = 1; i < N; i++) {
+            Interval<K> interval = intervals_[i];
+            V value = values_[i];
+            std::size_t j = i;
+            while (j > 0 && interval.key() < intervals_[j - 1].key()) {
+                intervals_[j] = intervals_[j - 1];
+                values_[j] = values_[j - 1];
+                j--;
+            }
+            intervals_[j] = interval;
+            values_[j] = value;
+        }
+        if constexpr (N > 0) {
+            build_max(0, N);
+        }
+    }
+
+    static constexpr std::size_t size() { return N; }
+
+    // In-order visit of every stored interval overlapping `interval`, with
+    // the same pruning as IntervalTree::walk.
+    template <typename Function>
+    constexpr void walk(const Interval<K>& interval, Function&& func) const {
+        if constexpr (N > 0) {
+            walk(0, N, interval, func);
+        }
+    }
+
+    constexpr bool overlaps(const Interval<K>& interval) const {
+        std::size_t first = 0;
+        std::size_t last = N;
+        while (first < last) {
+            std::size_t mid = first + (last - first) / 2;
+            if (intervals_[mid].overlap(interval)) {
+                return true;
+            }
+            std::size_t left_mid = first + (mid - first) / 2;
+            if (first < mid && max_[left_mid] >= interval.low_) {
+                last = mid;
+            } else {
+                first = mid + 1;
+            }
+        }
+        return false;
+    }
+
+private:
+    // Fills max_ for the subtree covering [first, last) and returns its max.
+    constexpr K build_max(std::size_t first, std::size_t last) {
+        std::size_t mid = first + (last - first) / 2;
+        K result = intervals_[mid].high_;
+        if (first < mid) {
+            K left = build_max(first, mid);
+            result = left > result ? left : result;
+        }
+        if (mid + 1 < last) {
+            K right = build_max(mid + 1, last);
+            result = right > result ? right : result;
+        }
+        max_[mid] = result;
+        return result;
+    }
+
+    template <typename Function>
+    constexpr void walk(std::size_t first, std::size_t last, const Interval<K>& interval,
+                        Function& func) const {
+        std::size_t mid = first + (last - first) / 2;
+        if (first < mid && interval.low_ <= max_[first + (mid - first) / 2]) {
+            walk(first, mid, interval, func);
+        }
+        if (intervals_[mid].overlap(interval)) {
+            func(intervals_[mid], values_[mid]);
+        }
+        std::size_t right = mid + 1;
+        if (right < last && intervals_[mid].key() <= interval.high_ &&
+            interval.low_ <= max_[right + (last - right) / 2]) {
+            walk(right, last, interval, func);
+        }
+    }
+
+    std::array<Interval<K>, N> intervals_{};
+    std::array<V, N> values_{};
+    std::array<K, N> max_{};
+};
+
+}  // namespace algo
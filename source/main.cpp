@@ -1,6 +1,12 @@
 #include "algo/binary_search_tree.hpp"
+#include "algo/red_black_tree.hpp"
 #include "algo/interval_tree.hpp"
 #include "test/interval_tree.hpp"
+#include "test/interval_coverage_tree.hpp"
+#include "test/static_interval_tree.hpp"
+#include "test/frozen_interval_tree.hpp"
+#include "test/concurrent_interval_tree.hpp"
+#include "test/sharded_interval_tree.hpp"
 
 #include <iostream>
 #include <vector>
@@ -114,13 +120,182 @@ bool testBSTAll() {
     return passed == total;
 }
 
+bool testBSTHandles() {
+    algo::BinarySearchTree<int, int> bst;
+    for (int i = 0; i < 32; i++) {
+        bst.add(i * 3, i);
+    }
+
+    // One descent, then removal through the handle.
+    auto node = bst.find(15);
+    if (node == nullptr || node->value() != 5) {
+        std::cout << "find() missed an existing key" << std::endl;
+        return false;
+    }
+    bst.remove(node);
+    if (bst.contains(15) || bst.size() != 31 || !bst.isBST()) {
+        std::cout << "remove(handle) failed" << std::endl;
+        return false;
+    }
+
+    // Extract, rekey, re-insert: same allocation ends up under a new key.
+    node = bst.find(27);
+    auto handle = bst.extract(node);
+    if (handle == nullptr || bst.contains(27) || bst.size() != 30) {
+        std::cout << "extract() failed" << std::endl;
+        return false;
+    }
+    handle->setKey(100);
+    handle->setValue(42);
+    bst.insert(std::move(handle));
+    if (!bst.contains(100) || bst.at(100) != 42 || bst.size() != 31 || !bst.isBST()) {
+        std::cout << "re-insert after rekey failed" << std::endl;
+        return false;
+    }
+
+    if (bst.find(12345) != nullptr) {
+        std::cout << "find() invented a key" << std::endl;
+        return false;
+    }
+    if (bst.extract(bst.find(12345)) != nullptr) {
+        std::cout << "extract(nullptr) should yield an empty handle" << std::endl;
+        return false;
+    }
+
+    std::cout << "Passed BST handle tests" << std::endl;
+    return true;
+}
+
+bool testRedBlackTree() {
+    // Monotonic insertion is the worst case for the plain BST; the balanced
+    // tree must stay logarithmic.
+    algo::RedBlackTree<int, int> rbt;
+    int sz = 1024;
+    for (int i = 0; i < sz; i++) {
+        rbt.add(i, i * 2);
+        if (!rbt.isValid()) {
+            std::cout << "Red-black tree invalid after adding " << i << std::endl;
+            return false;
+        }
+    }
+    if (rbt.size() != sz) {
+        std::cout << "Red-black tree has wrong size" << std::endl;
+        return false;
+    }
+    // 2 * log2(1024 + 1) rounds up to 21.
+    if (rbt.height() > 21) {
+        std::cout << "Red-black tree too tall: " << rbt.height() << std::endl;
+        return false;
+    }
+    for (int i = 0; i < sz; i++) {
+        if (!rbt.contains(i) || rbt.at(i) != i * 2) {
+            std::cout << "Red-black tree lost key " << i << std::endl;
+            return false;
+        }
+    }
+    for (int i = 0; i < sz; i += 2) {
+        rbt.remove(i);
+        if (!rbt.isValid()) {
+            std::cout << "Red-black tree invalid after removing " << i << std::endl;
+            return false;
+        }
+    }
+    if (rbt.size() != sz / 2) {
+        std::cout << "Red-black tree has wrong size after removals" << std::endl;
+        return false;
+    }
+    for (int i = 0; i < sz; i++) {
+        if (rbt.contains(i) != (i % 2 == 1)) {
+            std::cout << "Red-black tree membership wrong for " << i << std::endl;
+            return false;
+        }
+    }
+    std::cout << "Passed red-black tree tests" << std::endl;
+    return true;
+}
+
 int main() {
     if (!testBSTAll()) {
         return 1;
     }
+    if (!testBSTHandles()) {
+        return 1;
+    }
+    if (!testRedBlackTree()) {
+        return 1;
+    }
     if (!test::testIntervalTree()) {
         return 1;
     }
+    if (!test::testIntervalTreeBulkLoad()) {
+        return 1;
+    }
+    if (!test::testIntervalTreeInsertBatch()) {
+        return 1;
+    }
+    if (!test::testIntervalTreeQuery()) {
+        return 1;
+    }
+    if (!test::testIntervalTreeWalkBatch()) {
+        return 1;
+    }
+    if (!test::testIntervalTreeChurn()) {
+        return 1;
+    }
+    if (!test::testIntervalTreeInsertMerging()) {
+        return 1;
+    }
+    if (!test::testIntervalTreeCounts()) {
+        return 1;
+    }
+    if (!test::testIntervalTreeEarlyTermination()) {
+        return 1;
+    }
+    if (!test::testIntervalTreeOrderStatistics()) {
+        return 1;
+    }
+    if (!test::testIntervalTreeCompact()) {
+        return 1;
+    }
+    if (!test::testIntervalTreeQueryStats()) {
+        return 1;
+    }
+    if (!test::testIntervalTreeRangeRemove()) {
+        return 1;
+    }
+    if (!test::testIntervalTreeInsertHint()) {
+        return 1;
+    }
+    if (!test::testIntervalTreeBoundaryQueries()) {
+        return 1;
+    }
+    if (!test::testIntervalTreeCursor()) {
+        return 1;
+    }
+    if (!test::testIntervalCoverageTree()) {
+        return 1;
+    }
+    if (!test::testStaticIntervalTree()) {
+        return 1;
+    }
+    if (!test::testFrozenIntervalTree()) {
+        return 1;
+    }
+    if (!test::testMappedIntervalTree()) {
+        return 1;
+    }
+    if (!test::testFrozenParallelWalkAll()) {
+        return 1;
+    }
+    if (!test::testFrozenIntervalTreeSoA()) {
+        return 1;
+    }
+    if (!test::testConcurrentIntervalTree()) {
+        return 1;
+    }
+    if (!test::testShardedIntervalTree()) {
+        return 1;
+    }
     std::cout << "All tests passed." << std::endl;
 
     return 0;
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "algo/concurrent_interval_tree.hpp"
+
+#include <random>
+#include <thread>
+
+namespace test {
+
+bool testConcurrentIntervalTree() {
+    // Single-threaded sanity first.
+    {
+        algo::ConcurrentIntervalTree<int, int> tree;
+        tree.insert({1, 5}, 1);
+        tree.insert({10, 20}, 2);
+        auto reader = tree.reader();
+        int matches = 0;
+        reader.walk({3, 12}, [&](const auto& interval, const auto& value) { matches++; });
+        if (matches != 2 || tree.size() != 2) {
+            std::cout << "Concurrent tree single-thread walk failed" << std::endl;
+            return false;
+        }
+        if (!tree.remove_overlap({1, 1}) || tree.remove_overlap({100, 100})) {
+            std::cout << "Concurrent tree remove_overlap failed" << std::endl;
+            return false;
+        }
+    }
+
+    // One writer churning, two readers walking concurrently. Every delivered
+    // match must overlap its query; the epoch reclamation keeps unlinked
+    // nodes alive while readers are active.
+    algo::ConcurrentIntervalTree<int, int> tree;
+    for (int i = 0; i < 1000; i++) {
+        int low = i * 3 % 2000;
+        tree.insert({low, low + 20}, i);
+    }
+    std::atomic<bool> stop{false};
+    std::atomic<bool> failed{false};
+
+    std::thread writer([&] {
+        std::mt19937 g(1);
+        for (int i = 0; i < 20000 && !stop.load(); i++) {
+            int low = static_cast<int>(g() % 2000);
+            if (g() % 2 == 0) {
+                tree.insert({low, low + static_cast<int>(g() % 50)}, i);
+            } else {
+                tree.remove_overlap({low, low});
+            }
+        }
+        stop.store(true);
+    });
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 2; t++) {
+        readers.emplace_back([&, t] {
+            std::mt19937 g(100 + t);
+            auto reader = tree.reader();
+            while (!stop.load()) {
+                int low = static_cast<int>(g() % 2000);
+                algo::Interval<int> q{low, low + 100};
+                reader.walk(q, [&](const auto& interval, const auto& value) {
+                    if (!interval.overlap(q)) {
+                        failed.store(true);
+                    }
+                });
+            }
+        });
+    }
+
+    writer.join();
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    if (failed.load()) {
+        std::cout << "Concurrent walk delivered non-overlapping interval" << std::endl;
+        return false;
+    }
+    std::cout << "Passed concurrent tree tests" << std::endl;
+    return true;
+}
+
+}  // namespace test
@@ -0,0 +1,214 @@
+#pragma once
+
+#include "algo/frozen_interval_tree.hpp"
+#include "algo/frozen_interval_tree_soa.hpp"
+
+#include <cstdio>
+#include <random>
+
+namespace test {
+
+bool testFrozenIntervalTree() {
+    std::mt19937 g(2024);
+    for (int sz : {0, 1, 10, 1000}) {
+        algo::IntervalTree<int, int> tree;
+        for (int i = 0; i < sz; i++) {
+            int low = static_cast<int>(g() % 10000);
+            int high = low + static_cast<int>(g() % 200);
+            tree.insert({low, high}, i);
+        }
+        algo::FrozenIntervalTree<int, int> frozen(tree);
+        if (frozen.size() != static_cast<std::size_t>(sz)) {
+            std::cout << "Frozen tree lost nodes at size " << sz << std::endl;
+            return false;
+        }
+        for (int i = 0; i < 100; i++) {
+            int low = static_cast<int>(g() % 10000);
+            algo::Interval<int> q{low, low + static_cast<int>(g() % 500)};
+            std::vector<std::pair<int, int>> live;
+            tree.walk(q, [&](const auto& interval, const auto& value) {
+                live.emplace_back(interval.low_, value);
+            });
+            std::vector<std::pair<int, int>> snapshot;
+            frozen.walk(q, [&](const auto& interval, const auto& value) {
+                snapshot.emplace_back(interval.low_, value);
+            });
+            if (live != snapshot) {
+                std::cout << "Frozen walk mismatch at size " << sz << std::endl;
+                return false;
+            }
+            auto found = frozen.search(q);
+            if ((found != nullptr) != !live.empty()) {
+                std::cout << "Frozen search mismatch at size " << sz << std::endl;
+                return false;
+            }
+            if (found && !found->interval_.overlap(q)) {
+                std::cout << "Frozen search returned non-overlapping node" << std::endl;
+                return false;
+            }
+        }
+    }
+    std::cout << "Passed frozen tree tests" << std::endl;
+    return true;
+}
+
+bool testFrozenIntervalTreeSoA() {
+    std::mt19937 g(2027);
+    // Sizes below and above the scan threshold, plus one large enough to
+    // mix descents and range scans.
+    for (int sz : {0, 1, 10, 17, 1000}) {
+        algo::IntervalTree<int, int> tree;
+        for (int i = 0; i < sz; i++) {
+            int low = static_cast<int>(g() % 10000);
+            tree.insert({low, low + static_cast<int>(g() % 200)}, i);
+        }
+        algo::FrozenIntervalTreeSoA<int, int> soa(tree);
+        if (soa.size() != static_cast<std::size_t>(sz)) {
+            std::cout << "SoA tree lost nodes at size " << sz << std::endl;
+            return false;
+        }
+        for (int i = 0; i < 100; i++) {
+            int low = static_cast<int>(g() % 10000);
+            algo::Interval<int> q{low, low + static_cast<int>(g() % 500)};
+            std::vector<std::pair<int, int>> live;
+            tree.walk(q, [&](const auto& interval, const auto& value) {
+                live.emplace_back(interval.low_, value);
+            });
+            std::vector<std::pair<int, int>> snapshot;
+            soa.walk(q, [&](const auto& interval, const auto& value) {
+                snapshot.emplace_back(interval.low_, value);
+            });
+            if (live != snapshot) {
+                std::cout << "SoA walk mismatch at size " << sz << std::endl;
+                return false;
+            }
+        }
+    }
+    std::cout << "Passed SoA tree tests" << std::endl;
+    return true;
+}
+
+bool testFrozenParallelWalkAll() {
+    std::mt19937 g(2026);
+    algo::IntervalTree<int, int> tree;
+    for (int i = 0; i < 3000; i++) {
+        int low = static_cast<int>(g() % 10000);
+        int high = low + static_cast<int>(g() % 300);
+        tree.insert({low, high}, i);
+    }
+    algo::FrozenIntervalTree<int, int> frozen(tree);
+    std::vector<algo::Interval<int>> queries;
+    for (int i = 0; i < 2000; i++) {
+        int low = static_cast<int>(g() % 10000);
+        queries.push_back({low, low + static_cast<int>(g() % 400)});
+    }
+    std::sort(queries.begin(), queries.end(),
+              [](const auto& a, const auto& b) { return a.low_ < b.low_; });
+    std::vector<std::vector<std::pair<algo::Interval<int>, int>>> parallel;
+    frozen.parallel_walk_all(queries, parallel, 4);
+    if (parallel.size() != queries.size()) {
+        std::cout << "Parallel walk produced wrong result count" << std::endl;
+        return false;
+    }
+    for (std::size_t i = 0; i < queries.size(); i++) {
+        std::vector<std::pair<int, int>> expected;
+        frozen.walk(queries[i], [&](const auto& interval, const auto& value) {
+            expected.emplace_back(interval.low_, value);
+        });
+        std::vector<std::pair<int, int>> got;
+        for (const auto& match : parallel[i]) {
+            got.emplace_back(match.first.low_, match.second);
+        }
+        if (expected != got) {
+            std::cout << "Parallel walk mismatch at query " << i << std::endl;
+            return false;
+        }
+    }
+    std::cout << "Passed parallel walk tests" << std::endl;
+    return true;
+}
+
+bool testMappedIntervalTree() {
+    const std::string path = "/tmp/interval_tree_snapshot_test.bin";
+    std::mt19937 g(2025);
+    for (int sz : {0, 1, 1000}) {
+        algo::IntervalTree<int, int> tree;
+        for (int i = 0; i < sz; i++) {
+            int low = static_cast<int>(g() % 10000);
+            int high = low + static_cast<int>(g() % 200);
+            tree.insert({low, high}, i);
+        }
+        algo::FrozenIntervalTree<int, int> frozen(tree);
+        frozen.save(path);
+        algo::MappedIntervalTree<int, int> mapped(path);
+        if (mapped.size() != frozen.size()) {
+            std::cout << "Mapped tree lost nodes at size " << sz << std::endl;
+            std::remove(path.c_str());
+            return false;
+        }
+        for (int i = 0; i < 100; i++) {
+            int low = static_cast<int>(g() % 10000);
+            algo::Interval<int> q{low, low + static_cast<int>(g() % 500)};
+            std::vector<std::pair<int, int>> snapshot;
+            frozen.walk(q, [&](const auto& interval, const auto& value) {
+                snapshot.emplace_back(interval.low_, value);
+            });
+            std::vector<std::pair<int, int>> loaded;
+            mapped.walk(q, [&](const auto& interval, const auto& value) {
+                loaded.emplace_back(interval.low_, value);
+            });
+            if (snapshot != loaded) {
+                std::cout << "Mapped walk mismatch at size " << sz << std::endl;
+                std::remove(path.c_str());
+                return false;
+            }
+            if ((mapped.search(q) != nullptr) != !snapshot.empty()) {
+                std::cout << "Mapped search mismatch at size " << sz << std::endl;
+                std::remove(path.c_str());
+                return false;
+            }
+        }
+    }
+    // Loading garbage must fail cleanly, not crash.
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << "not a snapshot";
+    }
+    bool rejected = false;
+    try {
+        algo::MappedIntervalTree<int, int> mapped(path);
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    std::remove(path.c_str());
+    if (!rejected) {
+        std::cout << "Mapped tree accepted a corrupt snapshot" << std::endl;
+        return false;
+    }
+    // A header whose count would overflow the count * node_size bounds
+    // check must be rejected too, not wrap and map out of bounds.
+    {
+        algo::internal::FrozenSnapshotHeader header{};
+        std::memcpy(header.magic, algo::internal::kFrozenMagic, sizeof(header.magic));
+        header.version = algo::internal::kFrozenVersion;
+        header.node_size = sizeof(algo::MappedIntervalTree<int, int>::Node);
+        header.count = std::uint64_t{1} << 61;
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+    rejected = false;
+    try {
+        algo::MappedIntervalTree<int, int> mapped(path);
+    } catch (const std::runtime_error&) {
+        rejected = true;
+    }
+    std::remove(path.c_str());
+    if (!rejected) {
+        std::cout << "Mapped tree accepted an overflowing node count" << std::endl;
+        return false;
+    }
+    std::cout << "Passed mapped tree tests" << std::endl;
+    return true;
+}
+
+}  // namespace test
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "algo/interval_coverage_tree.hpp"
+
+#include <random>
+
+namespace test {
+
+bool testIntervalCoverageTree() {
+    std::mt19937 g(1357);
+    algo::IntervalCoverageTree<int> tree;
+    std::vector<algo::Interval<int>> stored;
+    for (int step = 0; step < 4000; step++) {
+        int op = static_cast<int>(g() % 3);
+        if (op != 0 || stored.empty()) {
+            int low = static_cast<int>(g() % 1000);
+            algo::Interval<int> interval{low, low + static_cast<int>(g() % 100)};
+            tree.insert(interval);
+            stored.push_back(interval);
+        } else {
+            std::size_t victim = g() % stored.size();
+            if (!tree.remove(stored[victim])) {
+                std::cout << "Coverage tree failed to remove a stored interval" << std::endl;
+                return false;
+            }
+            stored[victim] = stored.back();
+            stored.pop_back();
+        }
+        if (tree.size() != stored.size()) {
+            std::cout << "Coverage tree size mismatch at step " << step << std::endl;
+            return false;
+        }
+        if (step % 50 == 0) {
+            for (int i = 0; i < 20; i++) {
+                int point = static_cast<int>(g() % 1100);
+                std::size_t expected = 0;
+                for (const auto& interval : stored) {
+                    if (interval.low_ <= point && point <= interval.high_) {
+                        expected++;
+                    }
+                }
+                if (tree.coverage(point) != expected) {
+                    std::cout << "Coverage mismatch at point " << point << " step " << step
+                              << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+    if (tree.remove({-5, -1})) {
+        std::cout << "Coverage tree removed an interval that was never stored" << std::endl;
+        return false;
+    }
+    std::cout << "Passed coverage tree tests" << std::endl;
+    return true;
+}
+
+}  // namespace test
@@ -2,6 +2,8 @@
 
 #include "algo/interval_tree.hpp"
 
+#include <random>
+
 namespace test {
 class Solution {
 public:
@@ -94,4 +96,614 @@ bool testIntervalTree() {
     return true;
 }
 
+bool testIntervalTreeBulkLoad() {
+    std::mt19937 g(12345);
+    for (int sz : {0, 1, 2, 3, 7, 8, 9, 63, 64, 65, 100, 1000}) {
+        std::vector<std::pair<algo::Interval<int>, int>> items;
+        std::vector<int> lows;
+        for (int i = 0; i < sz; i++) {
+            int low = static_cast<int>(g() % 10000);
+            int high = low + static_cast<int>(g() % 100);
+            items.emplace_back(algo::Interval<int>{low, high}, i);
+            lows.push_back(low);
+        }
+        algo::IntervalTree<int, int> tree(std::move(items));
+        if (!tree.isValid()) {
+            std::cout << "Bulk-loaded tree invalid at size " << sz << std::endl;
+            return false;
+        }
+        std::sort(lows.begin(), lows.end());
+        std::vector<int> seen;
+        tree.inorder([&](const auto& interval, const auto& value) {
+            seen.push_back(interval.low_);
+        });
+        if (seen != lows) {
+            std::cout << "Bulk-loaded tree lost intervals at size " << sz << std::endl;
+            return false;
+        }
+    }
+    std::cout << "Passed bulk load tests" << std::endl;
+    return true;
+}
+
+bool testIntervalTreeInsertBatch() {
+    std::mt19937 g(24680);
+    // Batch sizes straddling the tree size exercise both the sorted-insert
+    // path and the merge-and-rebuild path.
+    for (int batch : {10, 200, 2000}) {
+        algo::IntervalTree<int, int> tree;
+        std::vector<int> lows;
+        for (int i = 0; i < 500; i++) {
+            int low = static_cast<int>(g() % 10000);
+            tree.insert({low, low + static_cast<int>(g() % 100)}, i);
+            lows.push_back(low);
+        }
+        std::vector<std::pair<algo::Interval<int>, int>> items;
+        for (int i = 0; i < batch; i++) {
+            int low = static_cast<int>(g() % 10000);
+            items.emplace_back(algo::Interval<int>{low, low + static_cast<int>(g() % 100)}, i);
+            lows.push_back(low);
+        }
+        tree.insert_batch(std::move(items));
+        if (!tree.isValid()) {
+            std::cout << "Tree invalid after insert_batch of " << batch << std::endl;
+            return false;
+        }
+        if (tree.size() != lows.size()) {
+            std::cout << "Wrong size after insert_batch of " << batch << std::endl;
+            return false;
+        }
+        std::sort(lows.begin(), lows.end());
+        std::vector<int> seen;
+        tree.inorder([&](const auto& interval, const auto& value) {
+            seen.push_back(interval.low_);
+        });
+        if (seen != lows) {
+            std::cout << "insert_batch lost intervals at batch " << batch << std::endl;
+            return false;
+        }
+    }
+    // Batch into an empty tree takes the bulk-load path.
+    algo::IntervalTree<int, int> tree;
+    tree.insert_batch({{{5, 9}, 0}, {{1, 3}, 1}, {{7, 20}, 2}});
+    if (!tree.isValid() || tree.size() != 3 || !tree.overlaps({4, 6})) {
+        std::cout << "insert_batch into empty tree failed" << std::endl;
+        return false;
+    }
+    std::cout << "Passed insert batch tests" << std::endl;
+    return true;
+}
+
+bool testIntervalTreeCursor() {
+    std::mt19937 g(44556);
+    algo::IntervalTree<int, int> tree;
+    std::vector<int> lows;
+    for (int i = 0; i < 1000; i++) {
+        int low = static_cast<int>(g() % 100000);
+        tree.insert({low, low + 10}, i);
+        lows.push_back(low);
+    }
+
+    // Quiet tree: chunked iteration must reproduce inorder exactly.
+    std::vector<int> seen;
+    algo::IntervalTree<int, int>::Cursor cursor(tree);
+    while (cursor.next(64, [&](const auto& interval, const auto& value) {
+        seen.push_back(interval.low_);
+    }) > 0) {
+    }
+    std::sort(lows.begin(), lows.end());
+    if (seen != lows) {
+        std::cout << "Cursor missed entries on a quiet tree" << std::endl;
+        return false;
+    }
+    if (!cursor.done() || cursor.next(64, [](const auto&, const auto&) {}) != 0) {
+        std::cout << "Cursor did not stay finished" << std::endl;
+        return false;
+    }
+
+    // Mutations between chunks: delivery must stay in nondecreasing key
+    // order, never revisit a delivered key, and still terminate.
+    algo::IntervalTree<int, int>::Cursor live(tree);
+    auto before = tree.generation();
+    int prev = -1;
+    bool ordered = true;
+    while (live.next(50, [&](const auto& interval, const auto& value) {
+        if (interval.low_ < prev) {
+            ordered = false;
+        }
+        prev = interval.low_;
+    }) > 0) {
+        int low = static_cast<int>(g() % 100000);
+        tree.insert({low, low + 10}, 0);
+        tree.remove(tree.search({low, low + 10}));
+    }
+    if (!ordered) {
+        std::cout << "Cursor went backwards across mutations" << std::endl;
+        return false;
+    }
+    if (tree.generation() == before) {
+        std::cout << "Mutations did not bump the generation" << std::endl;
+        return false;
+    }
+    std::cout << "Passed cursor tests" << std::endl;
+    return true;
+}
+
+bool testIntervalTreeBoundaryQueries() {
+    std::mt19937 g(11223);
+    algo::IntervalTree<int, int> tree;
+    std::vector<int> lows;
+    for (int i = 0; i < 500; i++) {
+        int low = static_cast<int>(g() % 5000);
+        tree.insert({low, low + static_cast<int>(g() % 80)}, i);
+        lows.push_back(low);
+    }
+    std::sort(lows.begin(), lows.end());
+    for (int i = 0; i < 300; i++) {
+        int key = static_cast<int>(g() % 5200) - 100;
+        auto lb = std::lower_bound(lows.begin(), lows.end(), key);
+        auto node = tree.lower_bound(key);
+        if ((node == nullptr) != (lb == lows.end()) ||
+            (node && node->interval_.low_ != *lb)) {
+            std::cout << "lower_bound mismatch at key " << key << std::endl;
+            return false;
+        }
+        auto ub = std::upper_bound(lows.begin(), lows.end(), key);
+        node = tree.next_after(key);
+        if ((node == nullptr) != (ub == lows.end()) ||
+            (node && node->interval_.low_ != *ub)) {
+            std::cout << "next_after mismatch at key " << key << std::endl;
+            return false;
+        }
+        node = tree.prev_before(key);
+        if ((node == nullptr) != (lb == lows.begin()) ||
+            (node && node->interval_.low_ != *(lb - 1))) {
+            std::cout << "prev_before mismatch at key " << key << std::endl;
+            return false;
+        }
+    }
+    // The gap must be free, start at or after the request, and (for these
+    // integer keys) not be preceded by a free window of the same width.
+    for (int i = 0; i < 100; i++) {
+        int from = static_cast<int>(g() % 5000);
+        int width = static_cast<int>(g() % 50);
+        int gap = tree.find_gap(from, width);
+        if (gap < from || tree.overlaps({gap, gap + width})) {
+            std::cout << "find_gap returned an occupied window" << std::endl;
+            return false;
+        }
+        for (int p = from; p < gap; p++) {
+            if (!tree.overlaps({p, p + width})) {
+                std::cout << "find_gap skipped an earlier free window at " << p << std::endl;
+                return false;
+            }
+        }
+    }
+    std::cout << "Passed boundary query tests" << std::endl;
+    return true;
+}
+
+bool testIntervalTreeInsertHint() {
+    // Ascending stream: each node hints the next.
+    algo::IntervalTree<int, int> tree;
+    algo::IntervalTree<int, int>::Node* hint = nullptr;
+    for (int i = 0; i < 2000; i++) {
+        int low = i * 5;
+        hint = tree.insert_hint(hint, {low, low + 8}, i);
+    }
+    if (!tree.isValid() || tree.size() != 2000) {
+        std::cout << "Tree invalid after hinted ascending inserts" << std::endl;
+        return false;
+    }
+    int prev = -1;
+    bool sorted = true;
+    tree.inorder([&](const auto& interval, const auto& value) {
+        if (interval.low_ < prev) {
+            sorted = false;
+        }
+        prev = interval.low_;
+    });
+    if (!sorted) {
+        std::cout << "Hinted inserts broke the key order" << std::endl;
+        return false;
+    }
+
+    // Garbage hints must fall back to a normal insert.
+    std::mt19937 g(13579);
+    algo::IntervalTree<int, int> scrambled;
+    algo::IntervalTree<int, int>::Node* last = nullptr;
+    for (int i = 0; i < 2000; i++) {
+        int low = static_cast<int>(g() % 10000);
+        last = scrambled.insert_hint(last, {low, low + static_cast<int>(g() % 100)}, i);
+    }
+    if (!scrambled.isValid() || scrambled.size() != 2000) {
+        std::cout << "Tree invalid after badly hinted inserts" << std::endl;
+        return false;
+    }
+    prev = -1;
+    sorted = true;
+    scrambled.inorder([&](const auto& interval, const auto& value) {
+        if (interval.low_ < prev) {
+            sorted = false;
+        }
+        prev = interval.low_;
+    });
+    if (!sorted) {
+        std::cout << "Badly hinted inserts broke the key order" << std::endl;
+        return false;
+    }
+    std::cout << "Passed insert hint tests" << std::endl;
+    return true;
+}
+
+bool testIntervalTreeRangeRemove() {
+    std::mt19937 g(86420);
+    // Narrow windows take the per-node path, wide ones the rebuild path.
+    for (int width : {50, 400, 9000}) {
+        algo::IntervalTree<int, int> tree;
+        std::vector<algo::Interval<int>> stored;
+        for (int i = 0; i < 1000; i++) {
+            int low = static_cast<int>(g() % 10000);
+            algo::Interval<int> interval{low, low + static_cast<int>(g() % 150)};
+            tree.insert({interval.low_, interval.high_}, i);
+            stored.push_back(interval);
+        }
+        int start = static_cast<int>(g() % 10000);
+        algo::Interval<int> window{start, start + width};
+
+        std::size_t expected_contained = 0;
+        for (const auto& interval : stored) {
+            if (window.low_ <= interval.low_ && interval.high_ <= window.high_) {
+                expected_contained++;
+            }
+        }
+        if (tree.remove_contained(window) != expected_contained) {
+            std::cout << "remove_contained removed wrong count at width " << width << std::endl;
+            return false;
+        }
+        if (!tree.isValid() || tree.size() != stored.size() - expected_contained) {
+            std::cout << "Tree broken after remove_contained at width " << width << std::endl;
+            return false;
+        }
+
+        std::size_t expected_overlapping = 0;
+        tree.inorder([&](const auto& interval, const auto& value) {
+            if (interval.overlap(window)) {
+                expected_overlapping++;
+            }
+        });
+        if (tree.remove_overlapping(window) != expected_overlapping || !tree.isValid()) {
+            std::cout << "remove_overlapping failed at width " << width << std::endl;
+            return false;
+        }
+        if (tree.overlaps(window)) {
+            std::cout << "Overlapping intervals survived removal at width " << width
+                      << std::endl;
+            return false;
+        }
+    }
+    std::cout << "Passed range remove tests" << std::endl;
+    return true;
+}
+
+bool testIntervalTreeQueryStats() {
+#ifdef ALGO_INTERVAL_TREE_STATS
+    std::mt19937 g(97531);
+    algo::IntervalTree<int, int> tree;
+    for (int i = 0; i < 1000; i++) {
+        int low = static_cast<int>(g() % 10000);
+        tree.insert({low, low + static_cast<int>(g() % 200)}, i);
+    }
+    auto& stats = algo::query_stats();
+    stats.reset();
+    std::uint64_t matches = 0;
+    for (int i = 0; i < 100; i++) {
+        int low = static_cast<int>(g() % 10000);
+        algo::Interval<int> q{low, low + static_cast<int>(g() % 500)};
+        tree.walk(q, [&](const auto& interval, const auto& value) { matches++; });
+        tree.search(q);
+    }
+    if (stats.matches < matches) {
+        std::cout << "Stats undercounted matches" << std::endl;
+        return false;
+    }
+    if (stats.nodes_visited < stats.matches || stats.nodes_visited == 0) {
+        std::cout << "Stats nodes_visited implausible" << std::endl;
+        return false;
+    }
+    // 1000 nodes: a red-black tree is at most 2*log2(n+1) ~ 20 deep.
+    if (stats.max_depth == 0 || stats.max_depth > 20) {
+        std::cout << "Stats max_depth implausible: " << stats.max_depth << std::endl;
+        return false;
+    }
+    if (stats.depth != 0) {
+        std::cout << "Stats depth did not return to zero" << std::endl;
+        return false;
+    }
+    if (stats.prunes == 0) {
+        std::cout << "Stats recorded no prunes over 100 queries" << std::endl;
+        return false;
+    }
+    stats.reset();
+    if (stats.nodes_visited != 0 || stats.max_depth != 0) {
+        std::cout << "Stats reset failed" << std::endl;
+        return false;
+    }
+#endif
+    std::cout << "Passed query stats tests" << std::endl;
+    return true;
+}
+
+bool testIntervalTreeQuery() {
+    std::mt19937 g(54321);
+    algo::IntervalTree<int, int> tree;
+    for (int i = 0; i < 1000; i++) {
+        int low = static_cast<int>(g() % 10000);
+        int high = low + static_cast<int>(g() % 200);
+        tree.insert({low, high}, i);
+    }
+    algo::IntervalTree<int, int>::QueryContext ctx;
+    for (int i = 0; i < 100; i++) {
+        int low = static_cast<int>(g() % 10000);
+        algo::Interval<int> q{low, low + static_cast<int>(g() % 500)};
+        std::vector<std::pair<int, int>> walked;
+        tree.walk(q, [&](const auto& interval, const auto& value) {
+            walked.emplace_back(interval.low_, value);
+        });
+        std::vector<std::pair<int, int>> queried;
+        tree.query(q, ctx, [&](const auto& interval, const auto& value) {
+            queried.emplace_back(interval.low_, value);
+        });
+        if (walked != queried) {
+            std::cout << "query() mismatch with walk() on query " << i << std::endl;
+            return false;
+        }
+    }
+    std::cout << "Passed query tests" << std::endl;
+    return true;
+}
+
+bool testIntervalTreeWalkBatch() {
+    std::mt19937 g(777);
+    algo::IntervalTree<int, int> tree;
+    for (int i = 0; i < 500; i++) {
+        int low = static_cast<int>(g() % 5000);
+        tree.insert({low, low + static_cast<int>(g() % 100)}, i);
+    }
+    std::vector<algo::Interval<int>> queries;
+    for (int i = 0; i < 200; i++) {
+        int low = static_cast<int>(g() % 5000);
+        queries.push_back({low, low + static_cast<int>(g() % 300)});
+    }
+    std::vector<std::vector<int>> expected(queries.size());
+    for (std::size_t qi = 0; qi < queries.size(); qi++) {
+        tree.walk(queries[qi], [&](const auto& interval, const auto& value) {
+            expected[qi].push_back(value);
+        });
+    }
+    std::vector<std::vector<int>> batched(queries.size());
+    tree.walk_batch(queries, [&](std::size_t qi, const auto& interval, const auto& value) {
+        batched[qi].push_back(value);
+    });
+    if (batched != expected) {
+        std::cout << "walk_batch mismatch with walk" << std::endl;
+        return false;
+    }
+    std::cout << "Passed walk_batch tests" << std::endl;
+    return true;
+}
+
+bool testIntervalTreeChurn() {
+    std::mt19937 g(31337);
+    algo::IntervalTree<int, int> tree;
+    int alive = 0;
+    for (int op = 0; op < 5000; op++) {
+        if (alive == 0 || g() % 3 != 0) {
+            int low = static_cast<int>(g() % 2000);
+            tree.insert({low, low + static_cast<int>(g() % 50)}, op);
+            alive++;
+        } else {
+            int point = static_cast<int>(g() % 2000);
+            auto node = tree.search({point, point});
+            if (node) {
+                tree.remove(node);
+                alive--;
+            }
+        }
+        if (op % 100 == 0 && !tree.isValid()) {
+            std::cout << "Tree invalid after churn op " << op << std::endl;
+            return false;
+        }
+    }
+    if (!tree.isValid()) {
+        std::cout << "Tree invalid after churn" << std::endl;
+        return false;
+    }
+    std::cout << "Passed churn tests" << std::endl;
+    return true;
+}
+
+bool testIntervalTreeInsertMerging() {
+    std::mt19937 g(4242);
+    for (int round = 0; round < 20; round++) {
+        algo::IntervalTree<int, int> tree;
+        std::vector<std::vector<int>> intervals;
+        for (int i = 0; i < 100; i++) {
+            int low = static_cast<int>(g() % 1000);
+            intervals.push_back({low, low + static_cast<int>(g() % 30)});
+        }
+        for (const auto& interval : intervals) {
+            tree.insert_merging({interval[0], interval[1]}, 1,
+                                [](int& acc, int other) { acc += other; });
+        }
+        if (!tree.isValid()) {
+            std::cout << "Tree invalid after insert_merging round " << round << std::endl;
+            return false;
+        }
+        // Brute-force merge of the same input for comparison.
+        auto sorted = intervals;
+        std::sort(sorted.begin(), sorted.end());
+        std::vector<std::vector<int>> expected;
+        for (const auto& interval : sorted) {
+            if (!expected.empty() && interval[0] <= expected.back()[1]) {
+                expected.back()[1] = std::max(expected.back()[1], interval[1]);
+            } else {
+                expected.push_back(interval);
+            }
+        }
+        std::vector<std::vector<int>> actual;
+        int total = 0;
+        tree.inorder([&](const auto& interval, const auto& value) {
+            actual.push_back({interval.low_, interval.high_});
+            total += value;
+        });
+        if (actual != expected || total != 100) {
+            std::cout << "insert_merging mismatch on round " << round << std::endl;
+            return false;
+        }
+    }
+    std::cout << "Passed insert_merging tests" << std::endl;
+    return true;
+}
+
+bool testIntervalTreeCounts() {
+    std::mt19937 g(9090);
+    algo::IntervalTree<int, int> tree;
+    for (int i = 0; i < 2000; i++) {
+        int low = static_cast<int>(g() % 5000);
+        tree.insert({low, low + static_cast<int>(g() % 100)}, i);
+    }
+    if (tree.size() != 2000 || !tree.isValid()) {
+        std::cout << "Bad size or invalid tree before count queries" << std::endl;
+        return false;
+    }
+    for (int i = 0; i < 200; i++) {
+        int low = static_cast<int>(g() % 5000);
+        algo::Interval<int> q{low, low + static_cast<int>(g() % 400)};
+        std::size_t walked = 0;
+        tree.walk(q, [&](const auto& interval, const auto& value) { walked++; });
+        if (tree.count_overlaps(q) != walked || tree.overlaps(q) != (walked > 0)) {
+            std::cout << "count_overlaps/overlaps mismatch on query " << i << std::endl;
+            return false;
+        }
+    }
+    std::cout << "Passed count tests" << std::endl;
+    return true;
+}
+
+bool testIntervalTreeEarlyTermination() {
+    algo::IntervalTree<int, int> tree;
+    for (int i = 0; i < 100; i++) {
+        tree.insert({i, i + 1}, i);
+    }
+    algo::Interval<int> q{0, 200};
+    int walked = 0;
+    tree.walk(q, [&](const auto& interval, const auto& value) {
+        walked++;
+        return walked < 3;
+    });
+    int queried = 0;
+    tree.query(q, [&](const auto& interval, const auto& value) {
+        queried++;
+        return queried < 3;
+    });
+    if (walked != 3 || queried != 3) {
+        std::cout << "Early termination visited " << walked << "/" << queried << std::endl;
+        return false;
+    }
+    std::cout << "Passed early termination tests" << std::endl;
+    return true;
+}
+
+bool testIntervalTreeOrderStatistics() {
+    std::mt19937 g(606);
+    algo::IntervalTree<int, int> tree;
+    std::vector<int> lows;
+    for (int i = 0; i < 1000; i++) {
+        int low = static_cast<int>(g() % 10000);
+        tree.insert({low, low + 5}, i);
+        lows.push_back(low);
+    }
+    std::sort(lows.begin(), lows.end());
+    for (std::size_t k = 0; k < lows.size(); k += 37) {
+        auto node = tree.kth(k);
+        if (!node || node->interval_.low_ != lows[k]) {
+            std::cout << "kth(" << k << ") mismatch" << std::endl;
+            return false;
+        }
+    }
+    if (tree.kth(lows.size()) != nullptr) {
+        std::cout << "kth past the end should be null" << std::endl;
+        return false;
+    }
+    for (int key : {-1, 0, 777, 5000, 9999, 20000}) {
+        auto expected = static_cast<std::size_t>(
+            std::lower_bound(lows.begin(), lows.end(), key) - lows.begin());
+        if (tree.rank(key) != expected) {
+            std::cout << "rank(" << key << ") mismatch" << std::endl;
+            return false;
+        }
+    }
+    std::cout << "Passed order statistics tests" << std::endl;
+    return true;
+}
+
+bool testIntervalTreeCompact() {
+    std::mt19937 g(707);
+    algo::IntervalTree<int, int> tree;
+    for (int i = 0; i < 2000; i++) {
+        int low = static_cast<int>(g() % 10000);
+        tree.insert({low, low + static_cast<int>(g() % 100)}, i);
+    }
+    if (tree.maybe_compact()) {
+        std::cout << "maybe_compact fired on an unchurned tree" << std::endl;
+        return false;
+    }
+    // Days of churn in miniature: remove/insert cycling at stable n.
+    for (int round = 0; round < 3000; round++) {
+        int low = static_cast<int>(g() % 10000);
+        auto victim = tree.search({low, low + 200});
+        if (victim) {
+            tree.remove(victim);
+            tree.insert({low, low + static_cast<int>(g() % 100)}, round);
+        }
+    }
+    std::vector<std::pair<algo::Interval<int>, int>> before;
+    tree.inorder([&](const auto& interval, const auto& value) {
+        before.emplace_back(interval, value);
+    });
+    auto generation = tree.generation();
+    if (!tree.maybe_compact()) {
+        std::cout << "maybe_compact ignored heavy churn" << std::endl;
+        return false;
+    }
+    if (tree.generation() == generation) {
+        std::cout << "compact must invalidate cursors" << std::endl;
+        return false;
+    }
+    if (!tree.isValid() || tree.size() != before.size()) {
+        std::cout << "compact damaged the tree" << std::endl;
+        return false;
+    }
+    std::vector<std::pair<algo::Interval<int>, int>> after;
+    tree.inorder([&](const auto& interval, const auto& value) {
+        after.emplace_back(interval, value);
+    });
+    for (std::size_t i = 0; i < before.size(); i++) {
+        if (before[i].first.low_ != after[i].first.low_ ||
+            before[i].first.high_ != after[i].first.high_ ||
+            before[i].second != after[i].second) {
+            std::cout << "compact changed the contents" << std::endl;
+            return false;
+        }
+    }
+    // The churn counter restarts with the fresh layout.
+    if (tree.maybe_compact()) {
+        std::cout << "maybe_compact fired twice in a row" << std::endl;
+        return false;
+    }
+    std::cout << "Passed compact tests" << std::endl;
+    return true;
+}
+
 }  // namespace test
\ No newline at end of file
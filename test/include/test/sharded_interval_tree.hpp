@@ -0,0 +1,98 @@
+#pragma once
+
+#include "algo/sharded_interval_tree.hpp"
+
+#include <random>
+#include <thread>
+
+namespace test {
+
+bool testShardedIntervalTree() {
+    // Single-threaded parity against one IntervalTree, with queries that
+    // straddle shard boundaries.
+    {
+        std::mt19937 g(2029);
+        std::vector<int> sample;
+        for (int i = 0; i < 200; i++) {
+            sample.push_back(static_cast<int>(g() % 10000));
+        }
+        algo::ShardedIntervalTree<int, int> sharded(sample, 8);
+        algo::IntervalTree<int, int> reference;
+        for (int i = 0; i < 2000; i++) {
+            int low = static_cast<int>(g() % 10000);
+            int high = low + static_cast<int>(g() % 300);
+            sharded.insert({low, high}, i);
+            reference.insert({low, high}, i);
+        }
+        if (sharded.size() != reference.size()) {
+            std::cout << "Sharded tree lost inserts" << std::endl;
+            return false;
+        }
+        for (int i = 0; i < 200; i++) {
+            int low = static_cast<int>(g() % 10000);
+            algo::Interval<int> q{low, low + static_cast<int>(g() % 500)};
+            std::vector<std::pair<int, int>> expected;
+            reference.walk(q, [&](const auto& interval, const auto& value) {
+                expected.emplace_back(interval.low_, value);
+            });
+            std::vector<std::pair<int, int>> got;
+            sharded.walk(q, [&](const auto& interval, const auto& value) {
+                got.emplace_back(interval.low_, value);
+            });
+            if (expected != got) {
+                std::cout << "Sharded walk mismatch at query " << i << std::endl;
+                return false;
+            }
+            if (sharded.overlaps(q) != !expected.empty()) {
+                std::cout << "Sharded overlaps mismatch at query " << i << std::endl;
+                return false;
+            }
+        }
+        std::size_t removed = sharded.remove_overlapping({2000, 4000});
+        if (removed != reference.remove_overlapping({2000, 4000}) ||
+            sharded.size() != reference.size()) {
+            std::cout << "Sharded remove_overlapping mismatch" << std::endl;
+            return false;
+        }
+    }
+
+    // Writer scaling path: 8 threads insert into disjoint key ranges that
+    // line up with the learned boundaries, so they should almost never
+    // share a shard lock. Afterwards everything must be present.
+    const int kThreads = 8;
+    const int kPerThread = 2000;
+    std::vector<int> sample;
+    for (int t = 0; t < kThreads; t++) {
+        for (int i = 0; i < 50; i++) {
+            sample.push_back(t * 10000 + i * 200);
+        }
+    }
+    algo::ShardedIntervalTree<int, int> sharded(sample, kThreads);
+    std::vector<std::thread> writers;
+    for (int t = 0; t < kThreads; t++) {
+        writers.emplace_back([&, t] {
+            std::mt19937 g(300 + t);
+            for (int i = 0; i < kPerThread; i++) {
+                int low = t * 10000 + static_cast<int>(g() % 9000);
+                sharded.insert({low, low + static_cast<int>(g() % 100)}, t * kPerThread + i);
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    if (sharded.size() != static_cast<std::size_t>(kThreads * kPerThread)) {
+        std::cout << "Sharded tree dropped concurrent inserts" << std::endl;
+        return false;
+    }
+    std::size_t total = 0;
+    sharded.walk({0, kThreads * 10000}, [&](const auto& interval, const auto& value) { total++; });
+    if (total != static_cast<std::size_t>(kThreads * kPerThread)) {
+        std::cout << "Sharded walk missed concurrent inserts" << std::endl;
+        return false;
+    }
+    std::cout << "Passed sharded tree tests" << std::endl;
+    return true;
+}
+
+}  // namespace test
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "algo/interval_tree.hpp"
+#include "algo/static_interval_tree.hpp"
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+namespace test {
+
+namespace {
+
+constexpr std::array<std::pair<algo::Interval<int>, int>, 6> kStaticRules{{
+    {{15, 20}, 0},
+    {{10, 30}, 1},
+    {{17, 19}, 2},
+    {{5, 8}, 3},
+    {{12, 15}, 4},
+    {{30, 40}, 5},
+}};
+
+constexpr algo::StaticIntervalTree<int, int, kStaticRules.size()> kStaticRuleTree(kStaticRules);
+
+constexpr int staticRuleMatches(const algo::Interval<int>& q) {
+    int count = 0;
+    kStaticRuleTree.walk(q, [&](const auto&, const auto&) { count++; });
+    return count;
+}
+
+}  // namespace
+
+// The table above is evaluated entirely at compile time; a wrong answer is
+// a build error, not a test failure.
+static_assert(kStaticRuleTree.size() == 6, "static tree dropped a rule");
+static_assert(kStaticRuleTree.overlaps({6, 7}), "static tree missed [5, 8]");
+static_assert(!kStaticRuleTree.overlaps({0, 4}), "static tree invented an overlap");
+static_assert(!kStaticRuleTree.overlaps({41, 100}), "static tree invented an overlap");
+static_assert(staticRuleMatches({14, 16}) == 3, "static walk miscounted");
+static_assert(staticRuleMatches({25, 35}) == 2, "static walk miscounted");
+static_assert(staticRuleMatches({9, 9}) == 0, "static walk miscounted");
+
+bool testStaticIntervalTree() {
+    // Runtime parity against the dynamic tree on a table-sized input.
+    constexpr std::size_t sz = 64;
+    std::mt19937 g(2028);
+    std::array<std::pair<algo::Interval<int>, int>, sz> items{};
+    algo::IntervalTree<int, int> live;
+    for (std::size_t i = 0; i < sz; i++) {
+        int low = static_cast<int>(g() % 1000);
+        int high = low + static_cast<int>(g() % 100);
+        items[i] = {{low, high}, static_cast<int>(i)};
+        live.insert({low, high}, static_cast<int>(i));
+    }
+    algo::StaticIntervalTree<int, int, sz> fixed(items);
+
+    for (int i = 0; i < 500; i++) {
+        int low = static_cast<int>(g() % 1000);
+        algo::Interval<int> q{low, low + static_cast<int>(g() % 150)};
+        std::vector<std::pair<int, int>> expected;
+        live.walk(q, [&](const auto& interval, const auto& value) {
+            expected.emplace_back(interval.low_, value);
+        });
+        std::vector<std::pair<int, int>> got;
+        fixed.walk(q, [&](const auto& interval, const auto& value) {
+            got.emplace_back(interval.low_, value);
+        });
+        // Equal lows may tie-break differently between the two layouts.
+        std::sort(expected.begin(), expected.end());
+        std::sort(got.begin(), got.end());
+        if (expected != got) {
+            std::cout << "Static walk mismatch at query " << i << std::endl;
+            return false;
+        }
+        if (fixed.overlaps(q) != !expected.empty()) {
+            std::cout << "Static overlaps mismatch at query " << i << std::endl;
+            return false;
+        }
+    }
+    std::cout << "Passed static tree tests" << std::endl;
+    return true;
+}
+
+}  // namespace test